@@ -1,12 +1,33 @@
+#include "batch.h"
+#include "chunked-matrix.h"
+#include "clock.h"
 #include "data.h"
+#include "engine.h"
+#include "fixed.h"
+#include "game.h"
 #include "high-io.h"
+#include "input-queue.h"
+#include "line-selector.h"
 #include "logger.h"
 #include "memory.h"
+#include "movement-table.h"
 #include "numeric.h"
+#include "packed-matrix.h"
+#include "physics.h"
+#include "platform-index.h"
+#include "platform-store.h"
 #include "random.h"
+#include "replay.h"
+#include "settings.h"
 #include "sort.h"
+#include "span-table.h"
+#include "state-hash.h"
 #include "text.h"
+#include "timing-wheel.h"
 #include "unity.h"
+#include "worker-pool.h"
+#include <limits.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -60,13 +81,15 @@ void test_get_random_perk_is_well_distributed(void) {
   int maximum_deviation = 0;
   double total = 0;
 
+  RandomState random;
   int count;
   int i;
 
   seed_random();
+  random = derive_random_state();
 
   for (i = 0; i < test_count; i++) {
-    counters[get_random_perk()]++;
+    counters[get_random_perk(&random)]++;
   }
   /* Assess the distribution of the values. */
   for (i = 0; i < PERK_COUNT; i++) {
@@ -365,6 +388,7 @@ void test_generate_platforms_avoids_multiple_platforms_on_the_same_line(void) {
   const size_t platform_count = 128;
   Platform *platforms = NULL;
   int *y_counter = NULL;
+  RandomState random = derive_random_state();
   BoundingBox box;
   size_t i;
   int y;
@@ -377,7 +401,7 @@ void test_generate_platforms_avoids_multiple_platforms_on_the_same_line(void) {
   box.min_y = 0;
   box.max_x = platform_count - 1;
   box.max_y = platform_count - 1;
-  generate_platforms(platforms, &box, platform_count, 1, 1);
+  generate_platforms(platforms, &box, platform_count, 1, 1, &random);
   /* Each platform in platforms should have a different y coordinate. */
   for (i = 0; i < platform_count; i++) {
     y = platforms[i].y;
@@ -458,23 +482,26 @@ void test_random_integer_is_evenly_distributed(void) {
 void test_select_random_line_blindly_with_one_empty_line(void) {
   const int tests = 1 << 8;
   const unsigned char array[1] = {0};
+  RandomState random = derive_random_state();
   int i;
   for (i = 0; i < tests; i++) {
-    TEST_ASSERT_EQUAL(0, select_random_line_blindly(array, 1));
+    TEST_ASSERT_EQUAL(0, select_random_line_blindly(array, 1, &random));
   }
 }
 
 void test_select_random_line_blindly_with_one_occupied_line(void) {
   const int tests = 1 << 8;
   const unsigned char array[1] = {1};
+  RandomState random = derive_random_state();
   int i;
   for (i = 0; i < tests; i++) {
     /* There is only one line to select, must select this one. */
-    TEST_ASSERT_EQUAL(0, select_random_line_blindly(array, 1));
+    TEST_ASSERT_EQUAL(0, select_random_line_blindly(array, 1, &random));
   }
 }
 
 void test_select_random_line_blindly_with_two_empty_lines(void) {
+  RandomState random = derive_random_state();
   /* Should not overflow after a multiplication by 3. */
   const int tests = 1 << 10;
   const int seven_sixteenths = 7 * tests / 16;
@@ -482,7 +509,7 @@ void test_select_random_line_blindly_with_two_empty_lines(void) {
   int counters[2] = {0, 0};
   int i;
   for (i = 0; i < tests; i++) {
-    counters[select_random_line_blindly(array, 2)] += 1;
+    counters[select_random_line_blindly(array, 2, &random)] += 1;
   }
   /* Counters should be roughly the same. */
   TEST_ASSERT_TRUE(counters[0] > seven_sixteenths);
@@ -493,10 +520,11 @@ void test_select_random_line_blindly_with_three_empty_lines(void) {
   const int tests = 1 << 12;
   const int five_sixteenths = 5 * tests / 16;
   const unsigned char array[3] = {0, 0, 0};
+  RandomState random = derive_random_state();
   int counters[3] = {0, 0, 0};
   int i;
   for (i = 0; i < tests; i++) {
-    counters[select_random_line_blindly(array, 3)] += 1;
+    counters[select_random_line_blindly(array, 3, &random)] += 1;
   }
   /* Counters should be roughly the same. */
   TEST_ASSERT_TRUE(counters[0] > five_sixteenths);
@@ -508,10 +536,11 @@ void test_select_random_line_blindly_with_occupied_middle_line(void) {
   const int tests = 1 << 10;
   const int seven_sixteenths = 7 * tests / 16;
   const unsigned char array[3] = {0, 1, 0};
+  RandomState random = derive_random_state();
   int counters[3] = {0, 0, 0};
   int i;
   for (i = 0; i < tests; i++) {
-    counters[select_random_line_blindly(array, 3)] += 1;
+    counters[select_random_line_blindly(array, 3, &random)] += 1;
   }
   TEST_ASSERT_EQUAL(0, counters[1]);
   TEST_ASSERT_TRUE(counters[0] > seven_sixteenths);
@@ -521,23 +550,26 @@ void test_select_random_line_blindly_with_occupied_middle_line(void) {
 void test_select_random_line_awarely_with_one_empty_line(void) {
   const int tests = 1 << 8;
   const unsigned char array[1] = {0};
+  RandomState random = derive_random_state();
   int i;
   for (i = 0; i < tests; i++) {
-    TEST_ASSERT_EQUAL(0, select_random_line_awarely(array, 1));
+    TEST_ASSERT_EQUAL(0, select_random_line_awarely(array, 1, &random));
   }
 }
 
 void test_select_random_line_awarely_with_one_occupied_line(void) {
   const int tests = 1 << 8;
   const unsigned char array[1] = {1};
+  RandomState random = derive_random_state();
   int i;
   for (i = 0; i < tests; i++) {
     /* There is only one line to select, must select this one. */
-    TEST_ASSERT_EQUAL(0, select_random_line_awarely(array, 1));
+    TEST_ASSERT_EQUAL(0, select_random_line_awarely(array, 1, &random));
   }
 }
 
 void test_select_random_line_awarely_with_two_empty_lines(void) {
+  RandomState random = derive_random_state();
   /* Should not overflow after a multiplication by 3. */
   const int tests = 1 << 10;
   const int seven_sixteenths = 7 * tests / 16;
@@ -545,7 +577,7 @@ void test_select_random_line_awarely_with_two_empty_lines(void) {
   int counters[2] = {0, 0};
   int i;
   for (i = 0; i < tests; i++) {
-    counters[select_random_line_awarely(array, 2)] += 1;
+    counters[select_random_line_awarely(array, 2, &random)] += 1;
   }
   /* Counters should be roughly the same. */
   TEST_ASSERT_TRUE(counters[0] > seven_sixteenths);
@@ -555,10 +587,11 @@ void test_select_random_line_awarely_with_two_empty_lines(void) {
 void test_select_random_line_awarely_with_three_empty_lines(void) {
   const int tests = 1 << 10;
   const unsigned char array[3] = {0, 0, 0};
+  RandomState random = derive_random_state();
   int counters[3] = {0, 0, 0};
   int i;
   for (i = 0; i < tests; i++) {
-    counters[select_random_line_awarely(array, 3)] += 1;
+    counters[select_random_line_awarely(array, 3, &random)] += 1;
   }
   /* The middle line is the most distant one. */
   TEST_ASSERT_EQUAL(counters[1], tests);
@@ -568,16 +601,1040 @@ void test_select_random_line_awarely_with_occupied_middle_line(void) {
   const int tests = 1 << 10;
   const int seven_sixteenths = 7 * tests / 16;
   const unsigned char array[3] = {0, 1, 0};
+  RandomState random = derive_random_state();
   int counters[3] = {0, 0, 0};
   int i;
   for (i = 0; i < tests; i++) {
-    counters[select_random_line_awarely(array, 3)] += 1;
+    counters[select_random_line_awarely(array, 3, &random)] += 1;
   }
   TEST_ASSERT_EQUAL(0, counters[1]);
   TEST_ASSERT_TRUE(counters[0] > seven_sixteenths);
   TEST_ASSERT_TRUE(counters[2] > seven_sixteenths);
 }
 
+void test_select_random_line_awarely_with_uneven_gaps(void) {
+  const unsigned char array[9] = {1, 0, 0, 0, 0, 1, 0, 0, 1};
+  RandomState random = derive_random_state();
+  int line;
+  int i;
+  for (i = 0; i < 1 << 8; i++) {
+    line = select_random_line_awarely(array, 9, &random);
+    TEST_ASSERT_TRUE(line == 2 || line == 3);
+  }
+}
+
+void test_line_selector_selects_the_furthest_lines(void) {
+  const int size = 37;
+  LineSelector *selector = create_line_selector(size);
+  RandomState random = derive_random_state();
+  unsigned char occupied[37];
+  int distances[37];
+  int maximum;
+  int line;
+  int i;
+  int j;
+  memset(occupied, 0, sizeof(occupied));
+  for (i = 0; i < 2 * size; i++) {
+    /* Lines outside of the array count as occupied. */
+    maximum = 0;
+    for (j = 0; j < size; j++) {
+      distances[j] = 0;
+      while (!occupied[j] && j - distances[j] >= 0 && j + distances[j] < size && !occupied[j - distances[j]] &&
+             !occupied[j + distances[j]]) {
+        distances[j]++;
+      }
+      maximum = max_int(maximum, distances[j]);
+    }
+    line = line_selector_select(selector, &random);
+    TEST_ASSERT_TRUE(line >= 0 && line < size);
+    TEST_ASSERT_EQUAL_INT(maximum, distances[line]);
+    occupied[line] = 1;
+  }
+  destroy_line_selector(selector);
+}
+
+void test_advance_fixed_keeps_sub_pixel_movement(void) {
+  /* Half a pixel per second at 4 frames per second moves one pixel every 8 frames. */
+  const Fixed speed = FIXED_ONE / 2;
+  long remainder = 0;
+  int moved = 0;
+  int i;
+  TEST_ASSERT_EQUAL_INT(-2, floor_divide(-3, 2));
+  TEST_ASSERT_EQUAL_INT(-2, floor_divide(3, -2));
+  TEST_ASSERT_EQUAL_INT(1, floor_divide(3, 2));
+  TEST_ASSERT_EQUAL_INT(-1, floor_divide(-2, 2));
+  for (i = 0; i < 8; i++) {
+    moved += advance_fixed(&remainder, speed, 4);
+  }
+  TEST_ASSERT_EQUAL_INT(1, moved);
+  TEST_ASSERT_EQUAL_INT(0, remainder);
+  for (i = 0; i < 8; i++) {
+    moved += advance_fixed(&remainder, -speed, 4);
+  }
+  TEST_ASSERT_EQUAL_INT(0, moved);
+  TEST_ASSERT_EQUAL_INT(0, remainder);
+}
+
+void test_sleep_until_reaches_the_deadline(void) {
+  const Nanoseconds start = get_nanoseconds();
+  const Nanoseconds deadline = start + 3 * NANOSECONDS_PER_MILLISECOND;
+  sleep_until(deadline);
+  TEST_ASSERT_TRUE(get_nanoseconds() >= deadline);
+  /* A deadline in the past returns immediately. */
+  sleep_until(start);
+}
+
+void test_packed_matrix_fill_and_get(void) {
+  PackedMatrix *matrix = create_packed_matrix(200, 3);
+  int x;
+  packed_matrix_fill(matrix, 60, 1, 70, 1, 1);
+  for (x = -1; x <= 200; x++) {
+    TEST_ASSERT_EQUAL_INT(x >= 60 && x < 130, packed_matrix_get(matrix, x, 1));
+    TEST_ASSERT_EQUAL_INT(0, packed_matrix_get(matrix, x, 0));
+  }
+  packed_matrix_fill(matrix, 64, 1, 2, 1, 0);
+  TEST_ASSERT_EQUAL_INT(1, packed_matrix_get(matrix, 63, 1));
+  TEST_ASSERT_EQUAL_INT(0, packed_matrix_get(matrix, 64, 1));
+  TEST_ASSERT_EQUAL_INT(0, packed_matrix_get(matrix, 65, 1));
+  TEST_ASSERT_EQUAL_INT(1, packed_matrix_get(matrix, 66, 1));
+  destroy_packed_matrix(matrix);
+}
+
+void test_packed_matrix_is_free(void) {
+  PackedMatrix *matrix = create_packed_matrix(300, 4);
+  packed_matrix_fill(matrix, 150, 2, 1, 1, 1);
+  TEST_ASSERT_TRUE(packed_matrix_is_free(matrix, 0, 0, 300, 2));
+  TEST_ASSERT_TRUE(packed_matrix_is_free(matrix, 0, 0, 150, 4));
+  TEST_ASSERT_TRUE(packed_matrix_is_free(matrix, 151, 0, 149, 4));
+  TEST_ASSERT_FALSE(packed_matrix_is_free(matrix, 0, 0, 300, 4));
+  TEST_ASSERT_FALSE(packed_matrix_is_free(matrix, 150, 2, 1, 1));
+  TEST_ASSERT_FALSE(packed_matrix_is_free(matrix, 100, -10, 60, 20));
+  /* Regions outside of the matrix are always free. */
+  TEST_ASSERT_TRUE(packed_matrix_is_free(matrix, -100, -100, 90, 400));
+  TEST_ASSERT_TRUE(packed_matrix_is_free(matrix, 300, 0, 64, 4));
+  destroy_packed_matrix(matrix);
+}
+
+void test_packed_matrix_finds_first_and_last_occupied_columns(void) {
+  PackedMatrix *matrix = create_packed_matrix(300, 4);
+  packed_matrix_fill(matrix, 70, 1, 1, 1, 1);
+  packed_matrix_fill(matrix, 130, 3, 5, 1, 1);
+  TEST_ASSERT_EQUAL_INT(70, packed_matrix_find_first(matrix, 0, 0, 300, 4));
+  TEST_ASSERT_EQUAL_INT(134, packed_matrix_find_last(matrix, 0, 0, 300, 4));
+  TEST_ASSERT_EQUAL_INT(130, packed_matrix_find_first(matrix, 71, 0, 229, 4));
+  TEST_ASSERT_EQUAL_INT(70, packed_matrix_find_last(matrix, 0, 0, 130, 4));
+  TEST_ASSERT_EQUAL_INT(132, packed_matrix_find_first(matrix, 132, 3, 10, 1));
+  TEST_ASSERT_EQUAL_INT(132, packed_matrix_find_last(matrix, 100, 3, 33, 1));
+  /* Free rectangles, even if they are partially outside of the matrix, return the column next to them. */
+  TEST_ASSERT_EQUAL_INT(300, packed_matrix_find_first(matrix, 0, 0, 300, 1));
+  TEST_ASSERT_EQUAL_INT(-21, packed_matrix_find_last(matrix, -20, 0, 90, 4));
+  TEST_ASSERT_EQUAL_INT(310, packed_matrix_find_first(matrix, 290, 0, 20, 4));
+  destroy_packed_matrix(matrix);
+}
+
+void test_span_table_tracks_overlapping_spans(void) {
+  SpanTable *table = create_span_table(100, 40, 10);
+  span_table_add(table, 10, 10, 20, 10);
+  span_table_add(table, 25, 10, 20, 10);
+  TEST_ASSERT_FALSE(span_table_is_free(table, 0, 15, 100, 1));
+  TEST_ASSERT_TRUE(span_table_is_free(table, 0, 0, 100, 10));
+  TEST_ASSERT_TRUE(span_table_is_free(table, 0, 20, 100, 20));
+  TEST_ASSERT_TRUE(span_table_is_free(table, 45, 0, 55, 40));
+  /* The overlapping cells must remain covered after removing one of the spans. */
+  span_table_remove(table, 10, 10, 20, 10);
+  TEST_ASSERT_TRUE(span_table_is_free(table, 10, 10, 15, 10));
+  TEST_ASSERT_EQUAL_INT(1, span_table_get(table, 25, 19));
+  TEST_ASSERT_EQUAL_INT(1, span_table_get(table, 44, 10));
+  TEST_ASSERT_EQUAL_INT(0, span_table_get(table, 45, 10));
+  span_table_remove(table, 25, 10, 20, 10);
+  TEST_ASSERT_TRUE(span_table_is_free(table, 0, 0, 100, 40));
+  destroy_span_table(table);
+}
+
+void test_span_table_removes_coverage_split_among_spans(void) {
+  SpanTable *table = create_span_table(100, 10, 10);
+  int x;
+  /* These two are merged into a single span. */
+  span_table_add(table, 0, 0, 10, 10);
+  span_table_add(table, 10, 0, 10, 10);
+  span_table_add(table, 5, 0, 10, 10);
+  span_table_remove(table, 5, 0, 10, 10);
+  span_table_remove(table, 0, 0, 10, 10);
+  for (x = 0; x < 100; x++) {
+    TEST_ASSERT_EQUAL_INT(x >= 10 && x < 20, span_table_get(table, x, 0));
+  }
+  /* Moving a span one column at a time should not fragment it. */
+  for (x = 10; x < 50; x++) {
+    span_table_remove(table, x, 0, 1, 10);
+    span_table_add(table, x + 10, 0, 1, 10);
+  }
+  TEST_ASSERT_EQUAL_INT(1, table->rows[0].span_count);
+  TEST_ASSERT_EQUAL_INT(50, table->rows[0].spans[0].min_x);
+  TEST_ASSERT_EQUAL_INT(60, table->rows[0].spans[0].max_x);
+  destroy_span_table(table);
+}
+
+void test_span_table_finds_first_and_last_covered_columns(void) {
+  SpanTable *table = create_span_table(100, 20, 10);
+  span_table_add(table, 40, 0, 20, 10);
+  span_table_add(table, 10, 0, 40, 10);
+  span_table_add(table, 70, 10, 10, 10);
+  TEST_ASSERT_EQUAL_INT(10, span_table_find_first(table, 0, 0, 100, 20));
+  TEST_ASSERT_EQUAL_INT(79, span_table_find_last(table, 0, 0, 100, 20));
+  TEST_ASSERT_EQUAL_INT(55, span_table_find_last(table, 0, 0, 56, 10));
+  TEST_ASSERT_EQUAL_INT(45, span_table_find_first(table, 45, 0, 10, 10));
+  TEST_ASSERT_EQUAL_INT(70, span_table_find_first(table, 60, 0, 40, 20));
+  TEST_ASSERT_EQUAL_INT(59, span_table_find_last(table, 0, 0, 70, 20));
+  TEST_ASSERT_EQUAL_INT(110, span_table_find_first(table, 80, 0, 30, 20));
+  TEST_ASSERT_EQUAL_INT(-11, span_table_find_last(table, -10, 10, 70, 10));
+  destroy_span_table(table);
+}
+
+void test_platform_index_moves_platforms_between_rows(void) {
+  PlatformIndex *index = create_platform_index(4, 3);
+  platform_index_set_row(index, 0, 1);
+  platform_index_set_row(index, 1, 1);
+  platform_index_set_row(index, 2, 3);
+  TEST_ASSERT_EQUAL_INT(PLATFORM_INDEX_NONE, platform_index_first(index, 0));
+  TEST_ASSERT_EQUAL_INT(1, platform_index_first(index, 1));
+  TEST_ASSERT_EQUAL_INT(0, platform_index_next(index, 1));
+  TEST_ASSERT_EQUAL_INT(PLATFORM_INDEX_NONE, platform_index_next(index, 0));
+  platform_index_set_row(index, 0, 3);
+  TEST_ASSERT_EQUAL_INT(3, platform_index_get_row(index, 0));
+  TEST_ASSERT_EQUAL_INT(PLATFORM_INDEX_NONE, platform_index_next(index, 1));
+  TEST_ASSERT_EQUAL_INT(0, platform_index_first(index, 3));
+  TEST_ASSERT_EQUAL_INT(2, platform_index_next(index, 0));
+  TEST_ASSERT_EQUAL_INT(1, index->counts[1]);
+  TEST_ASSERT_EQUAL_INT(2, index->counts[3]);
+  TEST_ASSERT_EQUAL_INT(1, index->occupied[1]);
+  /* Rows outside of the index are not indexed. */
+  platform_index_set_row(index, 1, 4);
+  TEST_ASSERT_EQUAL_INT(-1, platform_index_get_row(index, 1));
+  TEST_ASSERT_EQUAL_INT(PLATFORM_INDEX_NONE, platform_index_first(index, 1));
+  TEST_ASSERT_EQUAL_INT(0, index->counts[1]);
+  TEST_ASSERT_EQUAL_INT(0, index->occupied[1]);
+  destroy_platform_index(index);
+}
+
+void test_chunked_matrix_allocates_only_occupied_chunks(void) {
+  ChunkedMatrix *matrix = create_chunked_matrix(1000, 1000);
+  TEST_ASSERT_EQUAL_INT(0, chunked_matrix_count_chunks(matrix));
+  /* This rectangle spans four chunks. */
+  chunked_matrix_modify(matrix, 60, 60, 10, 10, 1);
+  chunked_matrix_modify(matrix, 65, 65, 10, 10, 1);
+  TEST_ASSERT_EQUAL_INT(4, chunked_matrix_count_chunks(matrix));
+  TEST_ASSERT_EQUAL_INT(2, chunked_matrix_get(matrix, 66, 66));
+  TEST_ASSERT_EQUAL_INT(60, chunked_matrix_find_first(matrix, 0, 60, 1000, 10));
+  TEST_ASSERT_EQUAL_INT(74, chunked_matrix_find_last(matrix, 0, 60, 1000, 10));
+  TEST_ASSERT_EQUAL_INT(1000, chunked_matrix_find_first(matrix, 0, 0, 1000, 60));
+  TEST_ASSERT_FALSE(chunked_matrix_is_free(matrix, 0, 0, 1000, 1000));
+  chunked_matrix_modify(matrix, 60, 60, 10, 10, -1);
+  TEST_ASSERT_EQUAL_INT(1, chunked_matrix_get(matrix, 66, 66));
+  TEST_ASSERT_EQUAL_INT(0, chunked_matrix_get(matrix, 60, 60));
+  /* Chunks are freed as soon as they become empty. */
+  chunked_matrix_modify(matrix, 65, 65, 10, 10, -1);
+  TEST_ASSERT_EQUAL_INT(0, chunked_matrix_count_chunks(matrix));
+  TEST_ASSERT_TRUE(chunked_matrix_is_free(matrix, -10, -10, 2000, 2000));
+  destroy_chunked_matrix(matrix);
+}
+
+void test_platform_store_mirrors_platforms_in_aligned_arrays(void) {
+  Platform platforms[3];
+  PlatformStore *store;
+  size_t i;
+  for (i = 0; i < 3; i++) {
+    platforms[i].x = (int)i;
+    platforms[i].y = 10 * (int)i;
+    platforms[i].w = 5;
+    platforms[i].h = 1;
+    platforms[i].speed = -(int)i;
+  }
+  store = create_platform_store(platforms, 3);
+  TEST_ASSERT_EQUAL_INT(0, (size_t)store->x % PLATFORM_STORE_ALIGNMENT);
+  TEST_ASSERT_EQUAL_INT(0, (size_t)store->pending % PLATFORM_STORE_ALIGNMENT);
+  TEST_ASSERT_EQUAL_INT(20, store->y[2]);
+  TEST_ASSERT_EQUAL_INT(-1, store->speed[1]);
+  platforms[1].x = 42;
+  platform_store_set(store, 1, platforms + 1);
+  TEST_ASSERT_EQUAL_INT(42, store->x[1]);
+  TEST_ASSERT_EQUAL_INT(2, store->x[2]);
+  destroy_platform_store(store);
+}
+
+void test_movement_table_moves_exactly_the_speed_every_second(void) {
+  const int rates[3] = {60, 200, 1000};
+  MovementTable *table;
+  unsigned long frame;
+  size_t row;
+  int speed;
+  int total;
+  int i;
+  for (i = 0; i < 3; i++) {
+    table = create_movement_table(rates[i]);
+    for (speed = 0; speed < 1000; speed += 7) {
+      row = movement_table_find(table, speed);
+      total = 0;
+      for (frame = 0; frame < (unsigned long)rates[i]; frame++) {
+        total += movement_table_get(table, row, frame);
+      }
+      TEST_ASSERT_EQUAL_INT(speed, total);
+    }
+    /* Finding a speed again returns the same row. */
+    TEST_ASSERT_EQUAL_INT(movement_table_find(table, 700), movement_table_find(table, 700));
+    TEST_ASSERT_EQUAL_INT(movement_table_get(table, row, 3), movement_table_get(table, row, 3 + rates[i]));
+    destroy_movement_table(table);
+  }
+}
+
+void test_timing_wheel_takes_due_items_in_order(void) {
+  TimingWheel *wheel = create_timing_wheel(4, 8);
+  timing_wheel_schedule(wheel, 5, 0);
+  timing_wheel_schedule(wheel, 2, 0);
+  timing_wheel_schedule(wheel, 7, 2);
+  TEST_ASSERT_EQUAL_INT(2, timing_wheel_take(wheel));
+  TEST_ASSERT_EQUAL_INT(2, wheel->due[0]);
+  TEST_ASSERT_EQUAL_INT(5, wheel->due[1]);
+  /* Slots are reused once the wheel goes past them. */
+  timing_wheel_schedule(wheel, 2, 4);
+  TEST_ASSERT_EQUAL_INT(0, timing_wheel_take(wheel));
+  TEST_ASSERT_EQUAL_INT(1, timing_wheel_take(wheel));
+  TEST_ASSERT_EQUAL_INT(7, wheel->due[0]);
+  TEST_ASSERT_EQUAL_INT(0, timing_wheel_take(wheel));
+  TEST_ASSERT_EQUAL_INT(1, timing_wheel_take(wheel));
+  TEST_ASSERT_EQUAL_INT(2, wheel->due[0]);
+  timing_wheel_reset(wheel, 9);
+  TEST_ASSERT_EQUAL_INT(0, timing_wheel_take(wheel));
+  TEST_ASSERT_EQUAL_INT(10, wheel->frame);
+  destroy_timing_wheel(wheel);
+}
+
+static void square_job(void *context, const size_t job) { ((size_t *)context)[job] = job * job; }
+
+void test_worker_pool_runs_every_job_once(void) {
+  WorkerPool *pool = create_worker_pool(4);
+  size_t results[100];
+  size_t batch;
+  size_t i;
+  TEST_ASSERT_NOT_NULL(pool);
+  /* Several batches make sure that the workers pick up new batches after finishing one. */
+  for (batch = 0; batch < 10; batch++) {
+    memset(results, 0, sizeof(results));
+    worker_pool_run(pool, square_job, results, 100);
+    for (i = 0; i < 100; i++) {
+      TEST_ASSERT_EQUAL_INT(i * i, results[i]);
+    }
+  }
+  destroy_worker_pool(pool);
+}
+
+static InputEvent make_test_input_event(const Command command, const double value, const int axis,
+                                        const Milliseconds time) {
+  InputEvent event;
+  event.command = command;
+  event.value = value;
+  event.axis = axis;
+  event.time = time;
+  return event;
+}
+
+void test_input_queue_applies_events_in_order_within_each_frame(void) {
+  CommandTable table;
+  InputQueue queue;
+  initialize_command_table(&table);
+  initialize_input_queue(&queue);
+  input_queue_push(&queue, make_test_input_event(COMMAND_JUMP, 1.0, 0, 10));
+  input_queue_push(&queue, make_test_input_event(COMMAND_JUMP, 0.0, 0, 12));
+  input_queue_push(&queue, make_test_input_event(COMMAND_RIGHT, 0.5, 1, 13));
+  input_queue_push(&queue, make_test_input_event(COMMAND_RIGHT, -0.25, 1, 14));
+  input_queue_push(&queue, make_test_input_event(COMMAND_INVEST, 1.0, 0, 30));
+  /* Axis motion was coalesced. */
+  TEST_ASSERT_EQUAL_INT(4, queue.count);
+  /* The release is held back so that the frame sees the jump. */
+  apply_input_queue(&queue, &table, 20);
+  TEST_ASSERT_EQUAL_FLOAT(1.0, table.status[COMMAND_JUMP]);
+  TEST_ASSERT_EQUAL_FLOAT(0.0, table.status[COMMAND_LEFT]);
+  TEST_ASSERT_EQUAL_INT(3, queue.count);
+  apply_input_queue(&queue, &table, 20);
+  TEST_ASSERT_EQUAL_FLOAT(0.0, table.status[COMMAND_JUMP]);
+  TEST_ASSERT_EQUAL_FLOAT(0.25, table.status[COMMAND_LEFT]);
+  TEST_ASSERT_EQUAL_FLOAT(0.0, table.status[COMMAND_RIGHT]);
+  TEST_ASSERT_EQUAL_FLOAT(0.0, table.status[COMMAND_INVEST]);
+  TEST_ASSERT_EQUAL_INT(1, queue.count);
+  apply_input_queue(&queue, &table, 30);
+  TEST_ASSERT_EQUAL_FLOAT(1.0, table.status[COMMAND_INVEST]);
+  TEST_ASSERT_EQUAL_INT(0, queue.count);
+}
+
+void test_step_game_applies_input_events_before_simulating(void) {
+  char name[64] = "Tester";
+  CommandTable table;
+  Player player;
+  Engine engine;
+  Game game;
+  InputEvent right;
+  int i;
+  initialize_command_table(&table);
+  player = create_player(name, &table);
+  initialize_engine(&engine, create_random_state(1));
+  game = create_game(&player, &engine);
+  right.command = COMMAND_RIGHT;
+  right.value = 1.0;
+  right.axis = 0;
+  right.time = 0;
+  step_game(&game, &right, 1);
+  TEST_ASSERT_EQUAL_FLOAT(1.0, table.status[COMMAND_RIGHT]);
+  for (i = 1; i < 100; i++) {
+    step_game(&game, NULL, 0);
+  }
+  TEST_ASSERT_EQUAL_INT(100, game.frame);
+  TEST_ASSERT_TRUE(is_game_running(&game));
+  destroy_game(&game);
+}
+
+void test_get_supporting_platform_finds_the_platform_under_the_player(void) {
+  char name[64] = "Tester";
+  CommandTable table;
+  Player player;
+  Engine engine;
+  Game game;
+  const Platform *platform;
+  initialize_settings();
+  initialize_command_table(&table);
+  player = create_player(name, &table);
+  initialize_engine(&engine, create_random_state(1));
+  game = create_game(&player, &engine);
+  platform = game.platforms;
+  player.x = platform->x + platform->w - 1;
+  player.y = platform->y - player.h;
+  TEST_ASSERT_EQUAL_PTR(platform, get_supporting_platform(&game));
+  player.y--;
+  TEST_ASSERT_NULL(get_supporting_platform(&game));
+  destroy_game(&game);
+}
+
+/* The scripted input dies often, so give the player enough lives for the game to last several keyframes. */
+#define REPLAY_TEST_LIVES 100
+
+static void script_replay_commands(CommandTable *table, const unsigned long frame) {
+  table->status[COMMAND_RIGHT] = (frame / 90) % 3 == 0 ? 1.0 : 0.0;
+  table->status[COMMAND_LEFT] = (frame / 90) % 3 == 1 ? 0.5 : 0.0;
+  if (frame % 45 == 0) {
+    table->status[COMMAND_JUMP] = 1.0;
+  }
+  if (frame % 700 == 0) {
+    table->status[COMMAND_INVEST] = 1.0;
+  }
+}
+
+static void assert_games_are_equal(const Game *const expected, const Game *const actual) {
+  size_t i;
+  TEST_ASSERT_EQUAL_UINT32(expected->frame, actual->frame);
+  TEST_ASSERT_EQUAL_INT(expected->player->x, actual->player->x);
+  TEST_ASSERT_EQUAL_INT(expected->player->y, actual->player->y);
+  TEST_ASSERT_EQUAL_INT(expected->player->score, actual->player->score);
+  TEST_ASSERT_EQUAL_INT(expected->player->lives, actual->player->lives);
+  TEST_ASSERT_EQUAL_UINT32(expected->platform_count, actual->platform_count);
+  for (i = 0; i < expected->platform_count; i++) {
+    TEST_ASSERT_EQUAL_INT(expected->platforms[i].x, actual->platforms[i].x);
+    TEST_ASSERT_EQUAL_INT(expected->platforms[i].y, actual->platforms[i].y);
+    TEST_ASSERT_EQUAL_INT(expected->platforms[i].w, actual->platforms[i].w);
+    TEST_ASSERT_EQUAL_INT(expected->platforms[i].speed, actual->platforms[i].speed);
+  }
+}
+
+static void assert_random_states_are_equal(const RandomState expected, const RandomState actual) {
+  TEST_ASSERT_EQUAL_UINT32(expected.x, actual.x);
+  TEST_ASSERT_EQUAL_UINT32(expected.y, actual.y);
+  TEST_ASSERT_EQUAL_UINT32(expected.z, actual.z);
+  TEST_ASSERT_EQUAL_UINT32(expected.w, actual.w);
+}
+
+void test_replay_reproduces_the_recorded_game(void) {
+  char name[64] = "Tester";
+  char path[MAXIMUM_PATH_SIZE];
+  CommandTable recorded_table;
+  CommandTable replayed_table;
+  CommandTable sought_table;
+  Player recorded_player;
+  Player replayed_player;
+  Player sought_player;
+  Engine recorded_engine;
+  Engine replayed_engine;
+  Engine sought_engine;
+  Game recorded;
+  Game replayed;
+  Game sought;
+  ReplayWriter *writer;
+  ReplayReader *reader;
+  unsigned long target;
+  /* The game always records with parsed settings, which a replay can restore exactly. */
+  initialize_settings();
+  get_full_path(path, "replay-test.bin");
+  initialize_command_table(&recorded_table);
+  recorded_player = create_player(name, &recorded_table);
+  recorded_player.lives = REPLAY_TEST_LIVES;
+  initialize_engine(&recorded_engine, create_random_state(1));
+  writer = create_replay_writer(path, &recorded_engine);
+  TEST_ASSERT_NOT_NULL(writer);
+  recorded = create_game(&recorded_player, &recorded_engine);
+  while (recorded.frame < 5000 && is_game_running(&recorded)) {
+    script_replay_commands(&recorded_table, recorded.frame);
+    record_game_step(writer, &recorded);
+  }
+  writer = destroy_replay_writer(writer);
+  TEST_ASSERT_EQUAL_UINT32(5000, recorded.frame);
+  /* Seek to a frame which is not a keyframe, both forwards and backwards. */
+  target = recorded.frame / 10 * 9 + 1;
+  initialize_engine(&replayed_engine, create_random_state(0));
+  reader = create_replay_reader(path, &replayed_engine);
+  TEST_ASSERT_NOT_NULL(reader);
+  initialize_command_table(&replayed_table);
+  replayed_player = create_player(name, &replayed_table);
+  replayed_player.lives = REPLAY_TEST_LIVES;
+  replayed = create_game(&replayed_player, &replayed_engine);
+  while (replay_game_step(reader, &replayed)) {
+  }
+  assert_games_are_equal(&recorded, &replayed);
+  assert_random_states_are_equal(recorded_engine.random, replayed_engine.random);
+  destroy_game(&replayed);
+  reader = destroy_replay_reader(reader);
+  initialize_engine(&sought_engine, create_random_state(0));
+  reader = create_replay_reader(path, &sought_engine);
+  initialize_command_table(&sought_table);
+  sought_player = create_player(name, &sought_table);
+  sought_player.lives = REPLAY_TEST_LIVES;
+  sought = create_game(&sought_player, &sought_engine);
+  TEST_ASSERT_TRUE(seek_replay(reader, &sought, target));
+  TEST_ASSERT_EQUAL_UINT32(target, sought.frame);
+  while (replay_game_step(reader, &sought)) {
+  }
+  assert_games_are_equal(&recorded, &sought);
+  assert_random_states_are_equal(recorded_engine.random, sought_engine.random);
+  TEST_ASSERT_TRUE(seek_replay(reader, &sought, target));
+  while (replay_game_step(reader, &sought)) {
+  }
+  assert_games_are_equal(&recorded, &sought);
+  assert_random_states_are_equal(recorded_engine.random, sought_engine.random);
+  destroy_game(&sought);
+  destroy_replay_reader(reader);
+  destroy_game(&recorded);
+  remove(path);
+}
+
+void test_state_hash_period_defaults_to_once_per_second(void) {
+  initialize_settings();
+  parse_settings("STATE_HASH_PERIOD = 0\nTICK_RATE = 60\n");
+  TEST_ASSERT_EQUAL_INT(60, get_state_hash_period());
+  parse_settings("TICK_RATE = 500\n");
+  TEST_ASSERT_EQUAL_INT(500, get_state_hash_period());
+  parse_settings("STATE_HASH_PERIOD = 7\n");
+  TEST_ASSERT_EQUAL_INT(7, get_state_hash_period());
+  parse_settings("STATE_HASH_PERIOD = -1\n");
+  TEST_ASSERT_EQUAL_INT(0, get_state_hash_period());
+  initialize_settings();
+}
+
+void test_replay_reports_the_first_diverging_frame(void) {
+  char name[64] = "Tester";
+  char path[MAXIMUM_PATH_SIZE];
+  CommandTable recorded_table;
+  CommandTable replayed_table;
+  Player recorded_player;
+  Player replayed_player;
+  Engine recorded_engine;
+  Engine replayed_engine;
+  Game recorded;
+  Game replayed;
+  ReplayWriter *writer;
+  ReplayReader *reader;
+  StateHash hash;
+  unsigned long frame = 0;
+  initialize_settings();
+  parse_settings("STATE_HASH_PERIOD = 1\n");
+  get_full_path(path, "replay-hash-test.bin");
+  initialize_command_table(&recorded_table);
+  recorded_player = create_player(name, &recorded_table);
+  initialize_engine(&recorded_engine, create_random_state(1));
+  writer = create_replay_writer(path, &recorded_engine);
+  recorded = create_game(&recorded_player, &recorded_engine);
+  while (recorded.frame < 300) {
+    script_replay_commands(&recorded_table, recorded.frame);
+    record_game_step(writer, &recorded);
+  }
+  destroy_replay_writer(writer);
+  hash = hash_game_state(&recorded);
+  recorded.player->score++;
+  TEST_ASSERT_TRUE(hash != hash_game_state(&recorded));
+  destroy_game(&recorded);
+  TEST_ASSERT_EQUAL_INT(REPLAY_IDENTICAL, verify_replay(path, &frame));
+  TEST_ASSERT_EQUAL_UINT32(300, frame);
+  initialize_engine(&replayed_engine, create_random_state(0));
+  reader = create_replay_reader(path, &replayed_engine);
+  initialize_command_table(&replayed_table);
+  replayed_player = create_player(name, &replayed_table);
+  replayed = create_game(&replayed_player, &replayed_engine);
+  while (replayed.frame < 100) {
+    replay_game_step(reader, &replayed);
+  }
+  TEST_ASSERT_FALSE(get_replay_divergence(reader, &frame));
+  replayed.player->score++;
+  while (replay_game_step(reader, &replayed)) {
+  }
+  TEST_ASSERT_TRUE(get_replay_divergence(reader, &frame));
+  TEST_ASSERT_EQUAL_UINT32(101, frame);
+  destroy_game(&replayed);
+  destroy_replay_reader(reader);
+  remove(path);
+}
+
+static void record_replay_test_game(const char *path, const unsigned long frames) {
+  char name[64] = "Tester";
+  CommandTable table;
+  Player player;
+  Engine engine;
+  Game game;
+  ReplayWriter *writer;
+  initialize_command_table(&table);
+  player = create_player(name, &table);
+  player.lives = REPLAY_TEST_LIVES;
+  initialize_engine(&engine, create_random_state(1));
+  writer = create_replay_writer(path, &engine);
+  game = create_game(&player, &engine);
+  while (game.frame < frames) {
+    script_replay_commands(&table, game.frame);
+    record_game_step(writer, &game);
+  }
+  destroy_replay_writer(writer);
+  destroy_game(&game);
+}
+
+static long get_file_size(const char *path) {
+  FILE *file = fopen(path, "rb");
+  long size;
+  fseek(file, 0, SEEK_END);
+  size = ftell(file);
+  fclose(file);
+  return size;
+}
+
+void test_replay_leaves_the_game_untouched_by_a_damaged_keyframe(void) {
+  char name[64] = "Tester";
+  char path[MAXIMUM_PATH_SIZE];
+  char damaged_path[MAXIMUM_PATH_SIZE];
+  char *bytes;
+  FILE *file;
+  CommandTable table;
+  Player player;
+  Engine engine;
+  Game game;
+  ReplayReader *reader;
+  StateHash hash;
+  RandomState random;
+  const unsigned long keyframe = REPLAY_KEYFRAME_PERIOD * get_tick_rate();
+  long size;
+  initialize_settings();
+  get_full_path(path, "replay-keyframe-test.bin");
+  get_full_path(damaged_path, "replay-damaged-test.bin");
+  /* The recording which stops before the keyframe tells where the keyframe starts in the one which goes past it. */
+  record_replay_test_game(damaged_path, keyframe);
+  size = get_file_size(damaged_path) - 1;
+  record_replay_test_game(path, keyframe + 10);
+  /* Keep the tag, the frame and the length of the keyframe and a few bytes of what it holds. */
+  size += 16;
+  bytes = resize_memory(NULL, size);
+  file = fopen(path, "rb");
+  TEST_ASSERT_EQUAL_UINT32(size, fread(bytes, 1, size, file));
+  fclose(file);
+  file = fopen(damaged_path, "wb");
+  fwrite(bytes, 1, size, file);
+  fclose(file);
+  resize_memory(bytes, 0);
+  initialize_engine(&engine, create_random_state(0));
+  reader = create_replay_reader(damaged_path, &engine);
+  TEST_ASSERT_NOT_NULL(reader);
+  initialize_command_table(&table);
+  player = create_player(name, &table);
+  player.lives = REPLAY_TEST_LIVES;
+  game = create_game(&player, &engine);
+  while (game.frame < keyframe / 2) {
+    replay_game_step(reader, &game);
+  }
+  hash = hash_game_state(&game);
+  random = engine.random;
+  TEST_ASSERT_FALSE(seek_replay(reader, &game, keyframe + 1));
+  TEST_ASSERT_EQUAL_UINT32(keyframe / 2, game.frame);
+  TEST_ASSERT_EQUAL_UINT32(hash, hash_game_state(&game));
+  assert_random_states_are_equal(random, engine.random);
+  /* The replay goes on from where it was, up to the damaged keyframe. */
+  while (replay_game_step(reader, &game)) {
+  }
+  TEST_ASSERT_EQUAL_UINT32(keyframe, game.frame);
+  destroy_game(&game);
+  destroy_replay_reader(reader);
+  remove(path);
+  remove(damaged_path);
+}
+
+#define ENGINE_TEST_GAMES 4
+#define ENGINE_TEST_FRAMES 2000
+
+typedef struct EngineTestRun {
+  CommandTable table;
+  Player player;
+  Engine engine;
+  Game game;
+} EngineTestRun;
+
+static void run_engine_test_game(void *context, size_t job) {
+  EngineTestRun *run = (EngineTestRun *)context + job;
+  while (run->game.frame < ENGINE_TEST_FRAMES && is_game_running(&run->game)) {
+    script_replay_commands(&run->table, run->game.frame);
+    step_game(&run->game, NULL, 0);
+  }
+}
+
+static void start_engine_test_game(EngineTestRun *run) {
+  char name[64] = "Tester";
+  initialize_command_table(&run->table);
+  run->player = create_player(name, &run->table);
+  run->player.lives = REPLAY_TEST_LIVES;
+  initialize_engine(&run->engine, create_random_state(1));
+  run->game = create_game(&run->player, &run->engine);
+}
+
+void test_games_with_separate_engines_simulate_independently(void) {
+  EngineTestRun alone;
+  EngineTestRun runs[ENGINE_TEST_GAMES];
+  WorkerPool *pool = create_worker_pool(ENGINE_TEST_GAMES);
+  size_t i;
+  TEST_ASSERT_NOT_NULL(pool);
+  initialize_settings();
+  start_engine_test_game(&alone);
+  run_engine_test_game(&alone, 0);
+  for (i = 0; i < ENGINE_TEST_GAMES; i++) {
+    start_engine_test_game(runs + i);
+  }
+  worker_pool_run(pool, run_engine_test_game, runs, ENGINE_TEST_GAMES);
+  for (i = 0; i < ENGINE_TEST_GAMES; i++) {
+    assert_games_are_equal(&alone.game, &runs[i].game);
+    assert_random_states_are_equal(alone.engine.random, runs[i].engine.random);
+    destroy_game(&runs[i].game);
+  }
+  destroy_game(&alone.game);
+  destroy_worker_pool(pool);
+}
+
+#define BATCH_TEST_GAMES 8
+#define BATCH_TEST_FRAMES 3000
+
+#define PARALLEL_TEST_FRAMES 3000
+/* Enough lives for the player to survive among this many platforms until the end of the test. */
+#define PARALLEL_TEST_LIVES 100000
+
+/*
+ * Hundreds of platforms which all move every frame, so that the due platforms are split among the threads by row
+ * every frame, and some of them leave the bounding box every few frames.
+ */
+#define PARALLEL_TEST_SETTINGS                                                                                         \
+  "PLATFORM_COUNT = 512\nPLATFORM_MINIMUM_SPEED = 12\nPLATFORM_MAXIMUM_SPEED = 16\nTICK_RATE = 200\n"
+
+void test_platforms_updated_in_parallel_match_the_serial_update(void) {
+  EngineTestRun serial;
+  EngineTestRun parallel;
+  initialize_settings();
+  parse_settings(PARALLEL_TEST_SETTINGS);
+  parse_settings("PLATFORM_THREADS = 1\n");
+  start_engine_test_game(&serial);
+  serial.player.lives = PARALLEL_TEST_LIVES;
+  parse_settings("PLATFORM_THREADS = 4\n");
+  start_engine_test_game(&parallel);
+  parallel.player.lives = PARALLEL_TEST_LIVES;
+  TEST_ASSERT_NULL(serial.game.worker_pool);
+  TEST_ASSERT_NOT_NULL(parallel.game.worker_pool);
+  TEST_ASSERT_EQUAL_UINT32(512, parallel.game.platform_count);
+  while (serial.game.frame < PARALLEL_TEST_FRAMES) {
+    script_replay_commands(&serial.table, serial.game.frame);
+    script_replay_commands(&parallel.table, parallel.game.frame);
+    step_game(&serial.game, NULL, 0);
+    step_game(&parallel.game, NULL, 0);
+    TEST_ASSERT_EQUAL_UINT32(hash_game_state(&serial.game), hash_game_state(&parallel.game));
+  }
+  assert_games_are_equal(&serial.game, &parallel.game);
+  assert_random_states_are_equal(serial.engine.random, parallel.engine.random);
+  destroy_game(&serial.game);
+  destroy_game(&parallel.game);
+  initialize_settings();
+}
+
+/*
+ * A box with a single row of tiles 40 pixels high, so that repositioned platforms always come back into it, with tiles
+ * 10 pixels wide.
+ */
+#define ROW_TEST_SETTINGS                                                                                              \
+  "LOGICAL_WIDTH = 400\nLOGICAL_HEIGHT = 240\nBAR_HEIGHT = 100\nTILE_WIDTH = 10\nTILE_HEIGHT = 40\n"
+#define ROW_TEST_FRAMES 1000
+
+/**
+ * Starts a game in a box with a single row of tiles, with the provided platforms instead of random ones. Other
+ * settings should be parsed before, after initialize_settings.
+ *
+ * The player is moved below the row, so that the platforms never touch it.
+ */
+static void start_row_test_game(EngineTestRun *run, const Platform *platforms, const size_t count) {
+  char settings[SMALL_STRING_BUFFER_SIZE];
+  parse_settings(ROW_TEST_SETTINGS);
+  sprintf(settings, "PLATFORM_COUNT = %lu\n", (unsigned long)count);
+  parse_settings(settings);
+  start_engine_test_game(run);
+  memcpy(run->game.platforms, platforms, sizeof(Platform) * count);
+  run->player.y = run->game.box->max_y + 1;
+  rebuild_game(&run->game);
+}
+
+static void update_row_test_platforms(Game *const game, const int predict) {
+  if (!predict) {
+    memset(game->collision_frames, 0, sizeof(unsigned long) * game->platform_count);
+  }
+  update_platforms(game);
+  game->frame++;
+}
+
+static int are_platforms_overlapping(const Platform *const a, const Platform *const b) {
+  return a->x < b->x + b->w && b->x < a->x + a->w;
+}
+
+/**
+ * Updates the platforms of two games, one of which checks the matrix for collisions every frame, and asserts that the
+ * first two platforms move the same in both, never overlap and end up in contact.
+ */
+static void assert_collision_predictions_are_exact(EngineTestRun *predicted, EngineTestRun *checked) {
+  const Platform *const a = predicted->game.platforms;
+  const Platform *const b = predicted->game.platforms + 1;
+  unsigned long contact = 0;
+  size_t i;
+  while (predicted->game.frame < ROW_TEST_FRAMES) {
+    update_row_test_platforms(&predicted->game, 1);
+    update_row_test_platforms(&checked->game, 0);
+    for (i = 0; i < predicted->game.platform_count; i++) {
+      TEST_ASSERT_EQUAL_INT(checked->game.platforms[i].x, predicted->game.platforms[i].x);
+    }
+    TEST_ASSERT_FALSE(are_platforms_overlapping(a, b));
+    if (contact == 0 && a->x + a->w == b->x) {
+      contact = predicted->game.frame;
+    }
+  }
+  TEST_ASSERT_TRUE(contact > 0);
+  TEST_ASSERT_EQUAL_INT(b->x, a->x + a->w);
+}
+
+void test_platforms_stop_at_contact_on_the_same_frame_with_collision_prediction(void) {
+  EngineTestRun predicted;
+  EngineTestRun checked;
+  Platform platforms[2];
+  platforms[0].x = 100;
+  platforms[0].y = 0;
+  platforms[0].w = 50;
+  platforms[0].h = 40;
+  platforms[0].speed = 230;
+  platforms[1] = platforms[0];
+  platforms[1].x = 300;
+  platforms[1].speed = -130;
+  initialize_settings();
+  start_row_test_game(&predicted, platforms, 2);
+  start_row_test_game(&checked, platforms, 2);
+  assert_collision_predictions_are_exact(&predicted, &checked);
+  destroy_game(&predicted.game);
+  destroy_game(&checked.game);
+  initialize_settings();
+}
+
+void test_repositioning_a_platform_into_a_row_clears_its_collision_predictions(void) {
+  EngineTestRun predicted;
+  EngineTestRun checked;
+  Platform platforms[2];
+  /* Nothing is ahead of the first platform until the second one leaves the box and comes back on the right. */
+  platforms[0].x = 200;
+  platforms[0].y = 0;
+  platforms[0].w = 50;
+  platforms[0].h = 40;
+  platforms[0].speed = 100;
+  platforms[1] = platforms[0];
+  platforms[1].x = 0;
+  platforms[1].w = 20;
+  platforms[1].speed = -150;
+  initialize_settings();
+  start_row_test_game(&predicted, platforms, 2);
+  start_row_test_game(&checked, platforms, 2);
+  update_row_test_platforms(&predicted.game, 1);
+  update_row_test_platforms(&checked.game, 0);
+  TEST_ASSERT_TRUE(predicted.game.collision_frames[0] == ULONG_MAX);
+  assert_collision_predictions_are_exact(&predicted, &checked);
+  destroy_game(&predicted.game);
+  destroy_game(&checked.game);
+  initialize_settings();
+}
+
+static const char *const COLLISION_BACKEND_SETTINGS[] = {
+    "COLLISION_BACKEND = DENSE\n", "COLLISION_BACKEND = PACKED\n", "COLLISION_BACKEND = SPANS\n",
+    "COLLISION_BACKEND = CHUNKED\n"};
+#define COLLISION_BACKEND_COUNT 4
+
+static void assert_rigid_matrices_are_equal(const Game *const expected, const Game *const actual) {
+  const BoundingBox *const box = expected->box;
+  int x;
+  int y;
+  for (y = box->min_y; y <= box->max_y; y++) {
+    for (x = box->min_x; x <= box->max_x; x++) {
+      TEST_ASSERT_EQUAL_INT(get_from_rigid_matrix(expected, x, y), get_from_rigid_matrix(actual, x, y));
+    }
+  }
+}
+
+void test_shifting_a_platform_matches_subtracting_and_adding_it(void) {
+  /* Moves by less than the width, by the width and by more, over the other platform and across both walls. */
+  static const int shifts[] = {1, 3, -1, -7, 49, -50, 120, -200, 51, -30};
+  EngineTestRun shifted;
+  EngineTestRun rebuilt;
+  Platform platforms[3];
+  Platform *platform;
+  size_t backend;
+  size_t i;
+  size_t j;
+  platforms[0].x = 100;
+  platforms[0].y = 0;
+  platforms[0].w = 50;
+  platforms[0].h = 40;
+  platforms[0].speed = 100;
+  platforms[1] = platforms[0];
+  platforms[1].x = 170;
+  platforms[1].w = 30;
+  platforms[2] = platforms[0];
+  platforms[2].x = 380;
+  platforms[2].w = 40;
+  for (backend = 0; backend < COLLISION_BACKEND_COUNT; backend++) {
+    initialize_settings();
+    parse_settings(COLLISION_BACKEND_SETTINGS[backend]);
+    start_row_test_game(&shifted, platforms, 3);
+    start_row_test_game(&rebuilt, platforms, 3);
+    for (i = 0; i < sizeof(shifts) / sizeof(shifts[0]); i++) {
+      /* The first platform passes over the second one, and the third one goes in and out of the right wall. */
+      for (j = 0; j < 3; j += 2) {
+        platform = shifted.game.platforms + j;
+        shift_rigid_matrix_platform(&shifted.game, platform, shifts[i]);
+        platform->x += shifts[i];
+        platform = rebuilt.game.platforms + j;
+        modify_rigid_matrix_platform(&rebuilt.game, platform, -1);
+        platform->x += shifts[i];
+        modify_rigid_matrix_platform(&rebuilt.game, platform, 1);
+      }
+      assert_rigid_matrices_are_equal(&rebuilt.game, &shifted.game);
+    }
+    destroy_game(&shifted.game);
+    destroy_game(&rebuilt.game);
+  }
+  initialize_settings();
+}
+
+/**
+ * Evaluates whether the player may be at the position, as the player physics does for moves of a single pixel.
+ */
+static int is_valid_player_position(const Game *const game, const int x, const int y) {
+  const Player *const player = game->player;
+  const BoundingBox *const box = game->box;
+  if (player->perk == PERK_POWER_INVINCIBILITY) {
+    if (x == box->min_x - 1 || x + player->w - 1 == box->max_x + 1) {
+      return 0;
+    }
+    if (y == box->min_y - 1 || y + player->h - 1 == box->max_y + 1) {
+      return 0;
+    }
+  }
+  return is_rigid_matrix_region_free(game, x, y, player->w, player->h);
+}
+
+static int step_player_per_pixel(const Game *const game, const int dx, const int dy) {
+  const int step_x = normalize(dx);
+  const int step_y = normalize(dy);
+  const int distance = abs(dx) + abs(dy);
+  const int x = game->player->x;
+  const int y = game->player->y;
+  int moved = 0;
+  while (moved < distance && is_valid_player_position(game, x + step_x * (moved + 1), y + step_y * (moved + 1))) {
+    moved++;
+  }
+  return moved;
+}
+
+void test_sweep_player_stops_where_moving_pixel_by_pixel_does(void) {
+  static const int moves[] = {-60, -13, -1, 1, 9, 60};
+  /* Invincibility also stops the player at the walls. */
+  static const Perk perks[] = {PERK_NONE, PERK_POWER_INVINCIBILITY};
+  EngineTestRun run;
+  Player *const player = &run.player;
+  Platform platforms[3];
+  int expected;
+  int x;
+  int y;
+  size_t i;
+  size_t j;
+  platforms[0].x = 100;
+  platforms[0].y = 0;
+  platforms[0].w = 50;
+  platforms[0].h = 40;
+  platforms[0].speed = 100;
+  platforms[1] = platforms[0];
+  platforms[1].x = 170;
+  platforms[1].w = 30;
+  platforms[2] = platforms[0];
+  platforms[2].x = 380;
+  platforms[2].w = 40;
+  initialize_settings();
+  start_row_test_game(&run, platforms, 3);
+  for (j = 0; j < sizeof(perks) / sizeof(perks[0]); j++) {
+    player->perk = perks[j];
+    /* Some of the positions overlap a platform, from which only moving pixel by pixel finds a way out. */
+    for (y = -50; y <= 50; y += 5) {
+      for (x = -15; x <= 415; x += 7) {
+        for (i = 0; i < sizeof(moves) / sizeof(moves[0]); i++) {
+          player->x = x;
+          player->y = y;
+          expected = step_player_per_pixel(&run.game, moves[i], 0);
+          TEST_ASSERT_EQUAL_INT(expected, sweep_player(&run.game, moves[i], 0));
+          TEST_ASSERT_EQUAL_INT(x + normalize(moves[i]) * expected, player->x);
+          TEST_ASSERT_EQUAL_INT(y, player->y);
+          player->x = x;
+          expected = step_player_per_pixel(&run.game, 0, moves[i]);
+          TEST_ASSERT_EQUAL_INT(expected, sweep_player(&run.game, 0, moves[i]));
+          TEST_ASSERT_EQUAL_INT(x, player->x);
+          TEST_ASSERT_EQUAL_INT(y + normalize(moves[i]) * expected, player->y);
+        }
+      }
+    }
+  }
+  player->perk = PERK_NONE;
+  destroy_game(&run.game);
+  initialize_settings();
+}
+
+void test_batch_results_do_not_depend_on_the_thread_count(void) {
+  BatchResult serial[BATCH_TEST_GAMES];
+  BatchResult parallel[BATCH_TEST_GAMES];
+  size_t i;
+  size_t j;
+  initialize_settings();
+  TEST_ASSERT_TRUE(run_batch(serial, BATCH_TEST_GAMES, 1, 1, BATCH_TEST_FRAMES));
+  TEST_ASSERT_TRUE(run_batch(parallel, BATCH_TEST_GAMES, 1, 4, BATCH_TEST_FRAMES));
+  for (i = 0; i < BATCH_TEST_GAMES; i++) {
+    TEST_ASSERT_EQUAL_UINT32(1 + i, parallel[i].seed);
+    TEST_ASSERT_EQUAL_INT(serial[i].score, parallel[i].score);
+    TEST_ASSERT_EQUAL_UINT32(serial[i].frames, parallel[i].frames);
+    TEST_ASSERT_TRUE(parallel[i].frames <= BATCH_TEST_FRAMES);
+    for (j = 0; j <= PERK_COUNT; j++) {
+      TEST_ASSERT_EQUAL_UINT32(serial[i].deaths[j], parallel[i].deaths[j]);
+    }
+  }
+}
+
 int main(void) {
   UNITY_BEGIN();
   log_message("Started running tests.");
@@ -629,6 +1686,36 @@ int main(void) {
   RUN_TEST(test_select_random_line_awarely_with_two_empty_lines);
   RUN_TEST(test_select_random_line_awarely_with_three_empty_lines);
   RUN_TEST(test_select_random_line_awarely_with_occupied_middle_line);
+  RUN_TEST(test_select_random_line_awarely_with_uneven_gaps);
+  RUN_TEST(test_line_selector_selects_the_furthest_lines);
+  RUN_TEST(test_advance_fixed_keeps_sub_pixel_movement);
+  RUN_TEST(test_sleep_until_reaches_the_deadline);
+  RUN_TEST(test_packed_matrix_fill_and_get);
+  RUN_TEST(test_packed_matrix_is_free);
+  RUN_TEST(test_packed_matrix_finds_first_and_last_occupied_columns);
+  RUN_TEST(test_span_table_tracks_overlapping_spans);
+  RUN_TEST(test_span_table_removes_coverage_split_among_spans);
+  RUN_TEST(test_span_table_finds_first_and_last_covered_columns);
+  RUN_TEST(test_platform_index_moves_platforms_between_rows);
+  RUN_TEST(test_chunked_matrix_allocates_only_occupied_chunks);
+  RUN_TEST(test_platform_store_mirrors_platforms_in_aligned_arrays);
+  RUN_TEST(test_movement_table_moves_exactly_the_speed_every_second);
+  RUN_TEST(test_timing_wheel_takes_due_items_in_order);
+  RUN_TEST(test_worker_pool_runs_every_job_once);
+  RUN_TEST(test_input_queue_applies_events_in_order_within_each_frame);
+  RUN_TEST(test_step_game_applies_input_events_before_simulating);
+  RUN_TEST(test_get_supporting_platform_finds_the_platform_under_the_player);
+  RUN_TEST(test_replay_reproduces_the_recorded_game);
+  RUN_TEST(test_replay_reports_the_first_diverging_frame);
+  RUN_TEST(test_state_hash_period_defaults_to_once_per_second);
+  RUN_TEST(test_replay_leaves_the_game_untouched_by_a_damaged_keyframe);
+  RUN_TEST(test_games_with_separate_engines_simulate_independently);
+  RUN_TEST(test_platforms_updated_in_parallel_match_the_serial_update);
+  RUN_TEST(test_platforms_stop_at_contact_on_the_same_frame_with_collision_prediction);
+  RUN_TEST(test_repositioning_a_platform_into_a_row_clears_its_collision_predictions);
+  RUN_TEST(test_shifting_a_platform_matches_subtracting_and_adding_it);
+  RUN_TEST(test_sweep_player_stops_where_moving_pixel_by_pixel_does);
+  RUN_TEST(test_batch_results_do_not_depend_on_the_thread_count);
   log_message("Finished running tests.");
   return UNITY_END();
 }
@@ -2,6 +2,7 @@
 #include "constants.h"
 #include "data.h"
 #include "high-io.h"
+#include "input.h"
 #include "logger.h"
 #include <string.h>
 
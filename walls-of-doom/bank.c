@@ -5,6 +5,7 @@
 #include "random.h"
 #include "score.h"
 #include "settings.h"
+#include <stdio.h>
 #include <stdlib.h>
 
 static double get_average_width(Game const *const game) {
@@ -48,9 +49,9 @@ static double get_difficulty(Game const *const game) {
   /* Faster platforms make the game harder. */
   const double speed_ratio = game_avg_speed / avg_speed;
   const double difficulty = width_ratio * speed_ratio;
-  /* Log the difficulty coefficient once. */
+  /* Log the difficulty coefficient once, from a game which logs. */
   static int logged_difficulty = 0;
-  if (!logged_difficulty) {
+  if (game->engine->logging && !logged_difficulty) {
     log_difficulty(difficulty);
     logged_difficulty = 1;
   }
@@ -68,6 +69,6 @@ int collect_investment(Game const *const game, const Investment investment) {
   const double normalized_max_return = min_return + normalized_delta;
   const int min_random = (int)(scaling_factor * min_return);
   const int max_random = (int)(scaling_factor * normalized_max_return);
-  const double random_factor = random_integer(min_random, max_random);
+  const double random_factor = random_state_integer(&game->engine->random, min_random, max_random);
   return (int)(random_factor * investment.amount / scaling_factor);
 }
@@ -25,8 +25,6 @@
 #define CREATE_SURFACE_FAIL "Failed to create surface in %s!"
 #define CREATE_TEXTURE_FAIL "Failed to create texture in %s!"
 
-#define PERK_FADING_INTERVAL FPS
-
 #define IMG_FLAGS IMG_INIT_PNG
 
 #define SDL_INIT_FLAGS (SDL_INIT_VIDEO | SDL_INIT_JOYSTICK)
@@ -55,6 +53,15 @@ int get_font_width(void) { return global_monospaced_font_width; }
 
 int get_font_height(void) { return global_monospaced_font_height; }
 
+SDL_Color to_sdl_color(Color color) {
+  SDL_Color sdl_color;
+  sdl_color.r = color.r;
+  sdl_color.g = color.g;
+  sdl_color.b = color.b;
+  sdl_color.a = color.a;
+  return sdl_color;
+}
+
 /**
  * Swap the renderer color by the provided color.
  *
@@ -202,7 +209,16 @@ Code initialize(Window **window, Renderer **renderer) {
   } else {
     renderer_flags = SDL_RENDERER_SOFTWARE;
   }
+  if (is_vsync_enabled()) {
+    renderer_flags |= SDL_RENDERER_PRESENTVSYNC;
+  }
   *renderer = SDL_CreateRenderer(*window, -1, renderer_flags);
+  /* Everything is drawn at the logical size and the renderer scales it to the window. */
+  if (is_logical_size_scaled()) {
+    SDL_RenderSetLogicalSize(*renderer, get_logical_width(), get_logical_height());
+    sprintf(log_buffer, "Scaling a %dx%d logical size to the window.", get_logical_width(), get_logical_height());
+    log_message(log_buffer);
+  }
   set_color(*renderer, COLOR_DEFAULT_BACKGROUND);
   clear(*renderer);
   return CODE_OK;
@@ -305,7 +321,7 @@ static void remove_first_breaks(char *string) {
 void print_long_text(char *string, Renderer *renderer) {
   char log_buffer[MAXIMUM_STRING_SIZE];
   const int font_width = get_font_width();
-  const int width = get_window_width() - 2 * get_padding() * font_width;
+  const int width = get_logical_width() - 2 * get_padding() * font_width;
   TTF_Font *font = get_font();
   SDL_Surface *surface;
   SDL_Texture *texture;
@@ -347,7 +363,7 @@ Code print_centered_horizontally(const int y, const int string_count, char **str
   char log_buffer[MAXIMUM_STRING_SIZE];
   const SDL_Color foreground = to_sdl_color(color_pair.foreground);
   const SDL_Color background = to_sdl_color(color_pair.background);
-  const int slice_size = get_window_width() / string_count;
+  const int slice_size = get_logical_width() / string_count;
   Font *font = global_monospaced_font;
   SDL_Surface *surface;
   SDL_Texture *texture;
@@ -391,7 +407,7 @@ Code print_centered_horizontally(const int y, const int string_count, char **str
 Code print_centered_vertically(const int string_count, char **strings, const ColorPair color_pair, Renderer *renderer) {
   const int text_line_height = global_monospaced_font_height;
   const int padding = 2 * get_padding() * global_monospaced_font_height;
-  const int available_window_height = get_window_height() - padding;
+  const int available_window_height = get_logical_height() - padding;
   const int text_lines_limit = available_window_height / text_line_height;
   int printed_count = string_count;
   int y;
@@ -399,7 +415,7 @@ Code print_centered_vertically(const int string_count, char **strings, const Col
   if (string_count > text_lines_limit) {
     printed_count = text_lines_limit;
   }
-  y = (get_window_height() - string_count * text_line_height) / 2;
+  y = (get_logical_height() - string_count * text_line_height) / 2;
   for (i = 0; i < printed_count; i++) {
     print_centered_horizontally(y, 1, strings + i, color_pair, renderer);
     y += text_line_height;
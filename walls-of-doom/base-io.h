@@ -31,6 +31,8 @@ int get_font_width(void);
 
 int get_font_height(void);
 
+SDL_Color to_sdl_color(Color color);
+
 /**
  * Swap the renderer color by the provided color.
  *
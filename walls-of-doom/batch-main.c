@@ -0,0 +1,102 @@
+#include "batch.h"
+#include "clock.h"
+#include "constants.h"
+#include "data.h"
+#include "logger.h"
+#include "memory.h"
+#include "settings.h"
+#include "text.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static void print_usage(void) {
+  printf("Usage: walls-of-doom-batch [--games N] [--seed N] [--threads N] [--frames N] [--set \"KEY = VALUE\"]...\n");
+}
+
+/**
+ * Parses a positive number, returning 0 if the argument is not one.
+ */
+static unsigned long parse_count(const char *argument) {
+  char *end;
+  const unsigned long count = strtoul(argument, &end, 10);
+  if (*argument == '\0' || *end != '\0' || *argument == '-') {
+    return 0;
+  }
+  return count;
+}
+
+/**
+ * Evaluates whether the settings describe a screen which the games can be simulated on.
+ *
+ * The settings file sets these, so without it they keep invalid defaults and the games end after a few frames.
+ */
+static int is_size_valid(void) {
+  const int tile_width = get_tile_width();
+  const int tile_height = get_tile_height();
+  const int bar_height = get_bar_height();
+  if (tile_width <= 0 || tile_height <= 0 || bar_height < 0) {
+    return 0;
+  }
+  return get_logical_width() >= tile_width && get_logical_height() - 2 * bar_height >= tile_height;
+}
+
+/**
+ * Simulates many games without a window and prints statistics about them, to evaluate the settings.
+ *
+ * The settings are read from the settings file, then changed by every --set argument. Each game runs on a single
+ * thread, as the batch runs games in parallel instead.
+ */
+int main(int argc, char *argv[]) {
+  unsigned long game_count = 1000;
+  unsigned long first_seed = 1;
+  unsigned long thread_count = 1;
+  unsigned long frame_limit = 0;
+  unsigned long *option;
+  BatchResult *results = NULL;
+  Nanoseconds start;
+  Nanoseconds elapsed;
+  int i;
+  if (!file_exists(SETTINGS_FILE)) {
+    printf("Could not find %s, which should be in the directory the batch runs in.\n", SETTINGS_FILE);
+    return 1;
+  }
+  initialize_settings();
+  for (i = 1; i < argc; i++) {
+    option = NULL;
+    if (string_equals(argv[i], "--games")) {
+      option = &game_count;
+    } else if (string_equals(argv[i], "--seed")) {
+      option = &first_seed;
+    } else if (string_equals(argv[i], "--threads")) {
+      option = &thread_count;
+    } else if (string_equals(argv[i], "--frames")) {
+      option = &frame_limit;
+    } else if (string_equals(argv[i], "--set") && i + 1 < argc) {
+      parse_settings(argv[++i]);
+      continue;
+    }
+    if (option == NULL || i + 1 == argc || (*option = parse_count(argv[++i])) == 0) {
+      print_usage();
+      return 1;
+    }
+  }
+  parse_settings("PLATFORM_THREADS = 1\n");
+  if (!is_size_valid()) {
+    printf("The settings do not set a valid logical size, tile size and bar height.\n");
+    return 1;
+  }
+  initialize_logger();
+  results = resize_memory(results, sizeof(BatchResult) * game_count);
+  start = get_nanoseconds();
+  if (!run_batch(results, game_count, first_seed, thread_count, frame_limit)) {
+    printf("Could not start %lu threads.\n", thread_count);
+    resize_memory(results, 0);
+    return 1;
+  }
+  elapsed = get_nanoseconds() - start;
+  printf("Simulated on %lu threads in %.2f s.\n", thread_count, (double)elapsed / NANOSECONDS_PER_SECOND);
+  write_batch_report(stdout, results, game_count);
+  resize_memory(results, 0);
+  finalize_logger();
+  return 0;
+}
@@ -0,0 +1,332 @@
+#include "batch.h"
+#include "constants.h"
+#include "engine.h"
+#include "fixed.h"
+#include "game.h"
+#include "memory.h"
+#include "physics.h"
+#include "settings.h"
+#include "sort.h"
+#include "worker-pool.h"
+#include <limits.h>
+
+/* How many times per second the script changes its commands. */
+#define SCRIPT_DECISIONS_PER_SECOND 10
+
+/* How close to a side wall, in tiles, the script considers itself in danger of being carried into it. */
+#define SCRIPT_WALL_MARGIN 6
+
+/* The script invests in about one of this many decisions. */
+#define SCRIPT_INVESTMENT_ODDS 100
+
+/* Mixed into the seed of a game to seed its script, so that the script does not draw the numbers the game draws. */
+#define SCRIPT_SEED_MASK 0x5bd1e995UL
+
+typedef struct BatchContext {
+  BatchResult *results;
+  unsigned long first_seed;
+  unsigned long frame_limit;
+} BatchContext;
+
+/**
+ * Returns where the platform is after the provided number of frames, ignoring collisions.
+ *
+ * Platforms going left have negative speeds, so this rounds with floor_divide to predict the same on every compiler.
+ */
+static int predict_platform_x(const Platform *const platform, const int frames) {
+  return platform->x + (int)floor_divide((long)platform->speed * frames, get_tick_rate());
+}
+
+/**
+ * Returns the horizontal center of the highest platform below the player that the player can still steer onto while
+ * falling, or -1 if there is none. Platforms which will be next to a side wall are left out.
+ */
+static int get_landing_center(const Game *const game) {
+  const Player *const player = game->player;
+  const int falling_speed = PLAYER_FALLING_SPEED * game->tile_h;
+  const int running_speed = PLAYER_RUNNING_SPEED * game->tile_w;
+  const int margin = 2 * game->tile_w;
+  const Platform *platform;
+  int best_distance = INT_MAX;
+  int center = -1;
+  int distance;
+  int frames;
+  int reach;
+  int x;
+  size_t i;
+  for (i = 0; i < game->platform_count; i++) {
+    platform = game->platforms + i;
+    distance = platform->y - (player->y + player->h);
+    if (distance < 0 || distance >= best_distance) {
+      continue;
+    }
+    frames = distance * get_tick_rate() / falling_speed;
+    x = predict_platform_x(platform, frames);
+    reach = running_speed * frames / get_tick_rate();
+    if (x >= game->box->min_x + margin && x + platform->w <= game->box->max_x - margin &&
+        x - reach < player->x + player->w && player->x - reach < x + platform->w) {
+      best_distance = distance;
+      center = x + platform->w / 2;
+    }
+  }
+  return center;
+}
+
+/**
+ * Evaluates whether a platform away from the side walls will be above the player, within the provided height, after
+ * the player had time to jump to it.
+ */
+static int has_platform_above(const Game *const game, const int height) {
+  const Player *const player = game->player;
+  const int margin = SCRIPT_WALL_MARGIN * game->tile_w;
+  const Platform *platform;
+  int x;
+  size_t i;
+  for (i = 0; i < game->platform_count; i++) {
+    platform = game->platforms + i;
+    x = predict_platform_x(platform, get_tick_rate() / 2);
+    if (platform->y + platform->h <= player->y && platform->y >= player->y - height &&
+        x + game->tile_w < player->x + player->w && player->x + game->tile_w < x + platform->w &&
+        platform->x > game->box->min_x + margin && platform->x + platform->w < game->box->max_x - margin) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Changes the commands several times per second, like a cautious player would.
+ *
+ * Standing on a platform, the script walks towards the Perk on the screen, or towards the middle of the screen if there
+ * is none, without walking off the platform. It jumps to platforms above it and to Perks within reach, and walks or
+ * jumps off platforms which carry it towards a side wall. While falling, it steers towards a platform it can land on.
+ * It never jumps so high that it would hit the top of the screen. Sometimes it invests.
+ */
+static void script_commands(const Game *const game, RandomState *random) {
+  const Player *const player = game->player;
+  const Platform *const platform = get_supporting_platform(game);
+  const BoundingBox *const box = game->box;
+  const int has_perk = game->perk != PERK_NONE;
+  const int jumping_height = PLAYER_JUMPING_HEIGHT * game->tile_h;
+  const int margin = SCRIPT_WALL_MARGIN * game->tile_w;
+  const int x = player->x + player->w / 2;
+  unsigned long period = get_tick_rate() / SCRIPT_DECISIONS_PER_SECOND;
+  int target = has_perk ? game->perk_x + game->tile_w / 2 : (box->min_x + box->max_x) / 2;
+  int landing;
+  int direction = 0;
+  int jump = 0;
+  if (period == 0) {
+    period = 1;
+  }
+  if (game->frame % period != 0) {
+    return;
+  }
+  if (!player->physics) {
+    player->table->status[COMMAND_JUMP] = 1.0;
+    return;
+  }
+  if (platform != NULL) {
+    if (x < target - game->tile_w && player->x + player->w + game->tile_w / 2 <= platform->x + platform->w) {
+      direction = 1;
+    } else if (x > target + game->tile_w && player->x - game->tile_w / 2 >= platform->x) {
+      direction = -1;
+    }
+    if ((platform->speed < 0 && player->x < box->min_x + margin) ||
+        (platform->speed > 0 && player->x + player->w > box->max_x - margin)) {
+      direction = platform->speed < 0 ? 1 : -1;
+      jump = 1;
+    }
+    if (has_perk && game->perk_y < player->y && game->perk_y >= player->y - jumping_height &&
+        abs(target - x) < 2 * game->tile_w) {
+      jump = 1;
+    }
+    /* Without a Perk to reach, the script only climbs once it is out of the upper third of the screen. */
+    if (has_platform_above(game, jumping_height)) {
+      jump = jump || has_perk || 3 * (player->y - box->min_y) > box->max_y - box->min_y;
+    }
+    if (player->y - jumping_height <= box->min_y + game->tile_h) {
+      jump = 0;
+    }
+  } else {
+    landing = get_landing_center(game);
+    if (landing >= 0) {
+      target = landing;
+    }
+    if (x < target - game->tile_w / 2) {
+      direction = 1;
+    } else if (x > target + game->tile_w / 2) {
+      direction = -1;
+    }
+    jump = player->can_double_jump && player->y > box->max_y - 4 * game->tile_h;
+  }
+  player->table->status[COMMAND_LEFT] = direction < 0 ? 1.0 : 0.0;
+  player->table->status[COMMAND_RIGHT] = direction > 0 ? 1.0 : 0.0;
+  if (jump) {
+    player->table->status[COMMAND_JUMP] = 1.0;
+  }
+  if (random_state_integer(random, 1, SCRIPT_INVESTMENT_ODDS) == 1) {
+    player->table->status[COMMAND_INVEST] = 1.0;
+  }
+}
+
+static size_t get_death_index(const Perk perk) { return perk < PERK_COUNT ? (size_t)perk : PERK_COUNT; }
+
+void run_batch_game(BatchResult *result, const unsigned long seed, const unsigned long frame_limit) {
+  char name[64] = "Batch";
+  RandomState script;
+  CommandTable table;
+  Player player;
+  Engine engine;
+  Game game;
+  Perk perk;
+  Perk screen_perk;
+  int lives;
+  Nanoseconds start;
+  Nanoseconds step_time;
+  size_t i;
+  result->seed = seed;
+  result->step_time = 0;
+  result->slowest_step = 0;
+  for (i = 0; i <= PERK_COUNT; i++) {
+    result->deaths[i] = 0;
+  }
+  for (i = 0; i < PERK_COUNT; i++) {
+    result->pickups[i] = 0;
+  }
+  script = create_random_state(seed ^ SCRIPT_SEED_MASK);
+  initialize_command_table(&table);
+  player = create_player(name, &table);
+  initialize_engine(&engine, create_random_state(seed));
+  game = create_game(&player, &engine);
+  while (is_game_running(&game) && (frame_limit == 0 || game.frame < frame_limit)) {
+    script_commands(&game, &script);
+    perk = player.perk;
+    screen_perk = game.perk;
+    lives = player.lives;
+    start = get_nanoseconds();
+    step_game(&game, NULL, 0);
+    step_time = get_nanoseconds() - start;
+    result->step_time += step_time;
+    if (step_time > result->slowest_step) {
+      result->slowest_step = step_time;
+    }
+    if (player.lives < lives) {
+      result->deaths[get_death_index(perk)] += lives - player.lives;
+    }
+    /* A Perk which leaves the screen before its time is up was picked up. */
+    if (screen_perk != PERK_NONE && game.perk == PERK_NONE && game.played_frames <= game.perk_end_frame) {
+      result->pickups[screen_perk]++;
+    }
+  }
+  result->score = player.score;
+  result->frames = game.frame;
+  destroy_game(&game);
+}
+
+static void run_batch_job(void *context, size_t job) {
+  const BatchContext *batch = (const BatchContext *)context;
+  run_batch_game(batch->results + job, batch->first_seed + job, batch->frame_limit);
+}
+
+int run_batch(BatchResult *results, const size_t game_count, const unsigned long first_seed, const size_t thread_count,
+              const unsigned long frame_limit) {
+  BatchContext context;
+  WorkerPool *pool = create_worker_pool(thread_count);
+  if (pool == NULL) {
+    return 0;
+  }
+  context.results = results;
+  context.first_seed = first_seed;
+  context.frame_limit = frame_limit;
+  /* Games are claimed one at a time, so threads which get short games move on to the next ones. */
+  worker_pool_run(pool, run_batch_job, &context, game_count);
+  destroy_worker_pool(pool);
+  return 1;
+}
+
+static int compare_longs(const void *a, const void *b) {
+  const long x = *(const long *)a;
+  const long y = *(const long *)b;
+  return (x > y) - (x < y);
+}
+
+/**
+ * Writes the minimum, some percentiles, the maximum and the mean of the values, sorting them.
+ */
+static void write_distribution(FILE *stream, const char *name, long *values, const size_t count) {
+  double total = 0.0;
+  size_t i;
+  for (i = 0; i < count; i++) {
+    total += values[i];
+  }
+  sort(values, count, sizeof(long), compare_longs);
+  fprintf(stream, "%s: minimum %ld, 10%% %ld, 50%% %ld, 90%% %ld, 99%% %ld, maximum %ld, mean %.2f.\n", name, values[0],
+          values[(count - 1) * 10 / 100], values[(count - 1) * 50 / 100], values[(count - 1) * 90 / 100],
+          values[(count - 1) * 99 / 100], values[count - 1], total / count);
+}
+
+static void write_perks(FILE *stream, const BatchResult *results, const size_t game_count) {
+  unsigned long deaths[PERK_COUNT + 1];
+  unsigned long pickups[PERK_COUNT + 1];
+  unsigned long total_deaths = 0;
+  unsigned long total_pickups = 0;
+  size_t i;
+  size_t j;
+  for (i = 0; i <= PERK_COUNT; i++) {
+    deaths[i] = 0;
+    pickups[i] = 0;
+    for (j = 0; j < game_count; j++) {
+      deaths[i] += results[j].deaths[i];
+      pickups[i] += i < PERK_COUNT ? results[j].pickups[i] : 0;
+    }
+    total_deaths += deaths[i];
+    total_pickups += pickups[i];
+  }
+  fprintf(stream, "Deaths: %.2f per game. Perks picked up: %.2f per game.\n", (double)total_deaths / game_count,
+          (double)total_pickups / game_count);
+  fprintf(stream, "  %-20s %10s %8s %10s\n", "Perk", "Pickups", "Share", "Deaths");
+  for (i = 0; i < PERK_COUNT; i++) {
+    fprintf(stream, "  %-20s %10lu %7.2f%% %10lu %7.2f%%\n", get_perk_name((Perk)i), pickups[i],
+            total_pickups ? 100.0 * pickups[i] / total_pickups : 0.0, deaths[i],
+            total_deaths ? 100.0 * deaths[i] / total_deaths : 0.0);
+  }
+  fprintf(stream, "  %-20s %10s %8s %10lu %7.2f%%\n", "No Perk", "", "", deaths[PERK_COUNT],
+          total_deaths ? 100.0 * deaths[PERK_COUNT] / total_deaths : 0.0);
+}
+
+static void write_step_times(FILE *stream, const BatchResult *results, const size_t game_count) {
+  Nanoseconds total = 0;
+  Nanoseconds slowest = 0;
+  unsigned long steps = 0;
+  size_t i;
+  for (i = 0; i < game_count; i++) {
+    total += results[i].step_time;
+    steps += results[i].frames;
+    if (results[i].slowest_step > slowest) {
+      slowest = results[i].slowest_step;
+    }
+  }
+  fprintf(stream, "Steps: %lu, mean %.0f ns, slowest %.0f ns.\n", steps, steps ? (double)total / steps : 0.0,
+          (double)slowest);
+}
+
+void write_batch_report(FILE *stream, const BatchResult *results, const size_t game_count) {
+  long *values = NULL;
+  size_t i;
+  fprintf(stream, "Games: %lu.\n", (unsigned long)game_count);
+  if (game_count == 0) {
+    return;
+  }
+  values = resize_memory(values, sizeof(long) * game_count);
+  for (i = 0; i < game_count; i++) {
+    values[i] = results[i].score;
+  }
+  write_distribution(stream, "Score", values, game_count);
+  for (i = 0; i < game_count; i++) {
+    values[i] = (long)results[i].frames;
+  }
+  write_distribution(stream, "Frames", values, game_count);
+  values = resize_memory(values, 0);
+  write_perks(stream, results, game_count);
+  write_step_times(stream, results, game_count);
+}
@@ -0,0 +1,53 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "clock.h"
+#include "perk.h"
+#include "score.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * What happened in one game of a batch.
+ */
+typedef struct BatchResult {
+  unsigned long seed;
+  Score score;
+  /* How many frames the game lasted, including the ones before the player first jumped. */
+  unsigned long frames;
+  /* How many times the player died with each Perk, the last counter being for deaths without a Perk. */
+  unsigned long deaths[PERK_COUNT + 1];
+  /* How many times the player picked up each Perk. */
+  unsigned long pickups[PERK_COUNT];
+  /* The time spent in step_game, which is one step per frame. */
+  Nanoseconds step_time;
+  Nanoseconds slowest_step;
+} BatchResult;
+
+/**
+ * Simulates a game seeded with the provided seed, played by a script which draws from a PRNG of its own.
+ *
+ * The script heads for Perks, so that the deaths and pickups per Perk say something about them.
+ *
+ * The game ends when the player runs out of lives or reaches the limit of played frames, or after frame_limit frames
+ * if it is not 0. The seed should not be 0, as that leaves the PRNG all zero.
+ */
+void run_batch_game(BatchResult *result, const unsigned long seed, const unsigned long frame_limit);
+
+/**
+ * Simulates games with the seeds first_seed to first_seed + game_count - 1 on the provided number of threads.
+ *
+ * Each game has an engine of its own, so the games share nothing but the settings, which should not change meanwhile.
+ *
+ * Returns 0 if the threads could not be started.
+ */
+int run_batch(BatchResult *results, const size_t game_count, const unsigned long first_seed, const size_t thread_count,
+              const unsigned long frame_limit);
+
+/**
+ * Writes the score distribution, how long the games lasted, the pickups and deaths per Perk and the step times to the
+ * stream.
+ */
+void write_batch_report(FILE *stream, const BatchResult *results, const size_t game_count);
+
+#endif
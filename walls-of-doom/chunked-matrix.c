@@ -0,0 +1,246 @@
+#include "chunked-matrix.h"
+#include "memory.h"
+#include "numeric.h"
+#include <string.h>
+
+ChunkedMatrix *create_chunked_matrix(const int width, const int height) {
+  ChunkedMatrix *matrix = resize_memory(NULL, sizeof(ChunkedMatrix));
+  size_t chunk_count;
+  size_t i;
+  matrix->width = width;
+  matrix->height = height;
+  matrix->chunks_per_row = (width + CHUNK_SIDE - 1) / CHUNK_SIDE;
+  matrix->chunk_rows = (height + CHUNK_SIDE - 1) / CHUNK_SIDE;
+  chunk_count = (size_t)matrix->chunks_per_row * matrix->chunk_rows;
+  matrix->chunks = resize_memory(NULL, sizeof(Chunk *) * (chunk_count ? chunk_count : 1));
+  for (i = 0; i < chunk_count; i++) {
+    matrix->chunks[i] = NULL;
+  }
+  return matrix;
+}
+
+ChunkedMatrix *destroy_chunked_matrix(ChunkedMatrix *matrix) {
+  size_t chunk_count;
+  size_t i;
+  if (matrix != NULL) {
+    chunk_count = (size_t)matrix->chunks_per_row * matrix->chunk_rows;
+    for (i = 0; i < chunk_count; i++) {
+      matrix->chunks[i] = resize_memory(matrix->chunks[i], 0);
+    }
+    matrix->chunks = resize_memory(matrix->chunks, 0);
+  }
+  return resize_memory(matrix, 0);
+}
+
+/**
+ * Clips the rectangle to the matrix, returning 0 if nothing is left of it.
+ */
+static int clip_rectangle(const ChunkedMatrix *const matrix, int *x, int *y, int *w, int *h) {
+  if (*x < 0) {
+    *w += *x;
+    *x = 0;
+  }
+  if (*y < 0) {
+    *h += *y;
+    *y = 0;
+  }
+  if (*x + *w > matrix->width) {
+    *w = matrix->width - *x;
+  }
+  if (*y + *h > matrix->height) {
+    *h = matrix->height - *y;
+  }
+  return *w > 0 && *h > 0;
+}
+
+static Chunk **get_chunk_slot(const ChunkedMatrix *const matrix, const int x, const int y) {
+  return matrix->chunks + (y / CHUNK_SIDE) * matrix->chunks_per_row + x / CHUNK_SIDE;
+}
+
+/**
+ * Returns the cells of the row of the chunk starting at column x of the matrix.
+ */
+static unsigned char *get_chunk_row(Chunk *chunk, const int x, const int y) {
+  return chunk->cells + (y % CHUNK_SIDE) * CHUNK_SIDE + x % CHUNK_SIDE;
+}
+
+/**
+ * Returns the first column after x which is in another chunk, or limit if that comes first.
+ */
+static int get_chunk_end(const int x, const int limit) { return min_int(limit, (x / CHUNK_SIDE + 1) * CHUNK_SIDE); }
+
+/**
+ * Returns how many rigid bodies occupy the cell at (x, y).
+ */
+unsigned char chunked_matrix_get(const ChunkedMatrix *const matrix, const int x, const int y) {
+  Chunk *chunk;
+  if (x < 0 || y < 0 || x >= matrix->width || y >= matrix->height) {
+    return 0;
+  }
+  chunk = *get_chunk_slot(matrix, x, y);
+  return chunk == NULL ? 0 : *get_chunk_row(chunk, x, y);
+}
+
+static Chunk *create_chunk(void) {
+  Chunk *chunk = resize_memory(NULL, sizeof(Chunk));
+  chunk->occupied = 0;
+  memset(chunk->cells, 0, sizeof(chunk->cells));
+  return chunk;
+}
+
+static void modify_chunk_row(Chunk *chunk, const int x, const int y, const int w, const int delta) {
+  unsigned char *row = get_chunk_row(chunk, x, y);
+  unsigned char before;
+  int i;
+  for (i = 0; i < w; i++) {
+    before = row[i];
+    row[i] += delta;
+    if (!before && row[i]) {
+      chunk->occupied++;
+    } else if (before && !row[i]) {
+      chunk->occupied--;
+    }
+  }
+}
+
+/**
+ * Adds delta to all cells of the rectangle, allocating and freeing chunks as needed.
+ */
+void chunked_matrix_modify(ChunkedMatrix *matrix, int x, int y, int w, int h, const int delta) {
+  Chunk **slot;
+  int chunk_x;
+  int chunk_y;
+  int end_x;
+  int end_y;
+  int j;
+  if (delta == 0 || !clip_rectangle(matrix, &x, &y, &w, &h)) {
+    return;
+  }
+  for (chunk_y = y; chunk_y < y + h; chunk_y = end_y) {
+    end_y = get_chunk_end(chunk_y, y + h);
+    for (chunk_x = x; chunk_x < x + w; chunk_x = end_x) {
+      end_x = get_chunk_end(chunk_x, x + w);
+      slot = get_chunk_slot(matrix, chunk_x, chunk_y);
+      if (*slot == NULL) {
+        if (delta < 0) {
+          /* There is nothing to remove from a chunk which is not there. */
+          continue;
+        }
+        *slot = create_chunk();
+      }
+      for (j = chunk_y; j < end_y; j++) {
+        modify_chunk_row(*slot, chunk_x, j, end_x - chunk_x, delta);
+      }
+      if ((*slot)->occupied == 0) {
+        *slot = resize_memory(*slot, 0);
+      }
+    }
+  }
+}
+
+/**
+ * Evaluates whether or not all cells of the rectangle are free.
+ */
+int chunked_matrix_is_free(const ChunkedMatrix *const matrix, int x, int y, int w, int h) {
+  return chunked_matrix_find_first(matrix, x, y, w, h) == x + w;
+}
+
+/**
+ * Returns the first occupied cell of the row in [from, to), or to if there is none.
+ */
+static int find_first_in_row(const ChunkedMatrix *const matrix, const int from, const int to, const int y) {
+  const unsigned char *row;
+  Chunk *chunk;
+  int end;
+  int i;
+  int x;
+  for (x = from; x < to; x = end) {
+    end = get_chunk_end(x, to);
+    chunk = *get_chunk_slot(matrix, x, y);
+    if (chunk != NULL) {
+      row = get_chunk_row(chunk, x, y);
+      for (i = 0; i < end - x; i++) {
+        if (row[i]) {
+          return x + i;
+        }
+      }
+    }
+  }
+  return to;
+}
+
+/**
+ * Returns the last occupied cell of the row in [from, to), or from - 1 if there is none.
+ */
+static int find_last_in_row(const ChunkedMatrix *const matrix, const int from, const int to, const int y) {
+  const unsigned char *row;
+  Chunk *chunk;
+  int start;
+  int i;
+  int x;
+  for (x = to; x > from; x = start) {
+    /* The chunk of the last column before x, from its first column or from. */
+    start = max_int(from, (x - 1) / CHUNK_SIDE * CHUNK_SIDE);
+    chunk = *get_chunk_slot(matrix, start, y);
+    if (chunk != NULL) {
+      row = get_chunk_row(chunk, start, y);
+      for (i = x - start - 1; i >= 0; i--) {
+        if (row[i]) {
+          return start + i;
+        }
+      }
+    }
+  }
+  return from - 1;
+}
+
+/**
+ * Returns the leftmost column of the rectangle with an occupied cell, or x + w if all of its cells are free.
+ */
+int chunked_matrix_find_first(const ChunkedMatrix *const matrix, int x, int y, int w, int h) {
+  const int none = x + w;
+  int found;
+  int j;
+  if (!clip_rectangle(matrix, &x, &y, &w, &h)) {
+    return none;
+  }
+  found = x + w;
+  /* Each row only needs to be searched up to the best column found so far. */
+  for (j = y; j < y + h && found > x; j++) {
+    found = find_first_in_row(matrix, x, found, j);
+  }
+  return found == x + w ? none : found;
+}
+
+/**
+ * Returns the rightmost column of the rectangle with an occupied cell, or x - 1 if all of its cells are free.
+ */
+int chunked_matrix_find_last(const ChunkedMatrix *const matrix, int x, int y, int w, int h) {
+  const int none = x - 1;
+  int found;
+  int j;
+  if (!clip_rectangle(matrix, &x, &y, &w, &h)) {
+    return none;
+  }
+  found = x - 1;
+  /* Each row only needs to be searched down to the best column found so far. */
+  for (j = y; j < y + h && found < x + w - 1; j++) {
+    found = find_last_in_row(matrix, found + 1, x + w, j);
+  }
+  return found == x - 1 ? none : found;
+}
+
+/**
+ * Returns how many chunks are currently allocated.
+ */
+size_t chunked_matrix_count_chunks(const ChunkedMatrix *const matrix) {
+  const size_t chunk_count = (size_t)matrix->chunks_per_row * matrix->chunk_rows;
+  size_t count = 0;
+  size_t i;
+  for (i = 0; i < chunk_count; i++) {
+    if (matrix->chunks[i] != NULL) {
+      count++;
+    }
+  }
+  return count;
+}
@@ -0,0 +1,71 @@
+#ifndef CHUNKED_MATRIX_H
+#define CHUNKED_MATRIX_H
+
+#include <stdlib.h>
+
+/**
+ * A sparse counting matrix made of square chunks.
+ *
+ * Each cell counts how many rigid bodies occupy it, just like in a dense matrix, but the cells are stored in chunks of
+ * CHUNK_SIDE x CHUNK_SIDE which are only allocated while some of their cells are nonzero. Memory therefore follows the
+ * occupied area instead of the area of the matrix.
+ *
+ * All coordinates are relative to the top left corner of the matrix. Cells outside of the matrix are always free and
+ * writes to them are ignored.
+ */
+
+#define CHUNK_SIDE 64
+
+typedef struct Chunk {
+  /* How many cells of this chunk are nonzero. */
+  int occupied;
+  unsigned char cells[CHUNK_SIDE * CHUNK_SIDE];
+} Chunk;
+
+typedef struct ChunkedMatrix {
+  int width;
+  int height;
+  int chunks_per_row;
+  int chunk_rows;
+  /* NULL for chunks which have no nonzero cells. */
+  Chunk **chunks;
+} ChunkedMatrix;
+
+/**
+ * Creates a new ChunkedMatrix with all cells free and no chunks allocated.
+ */
+ChunkedMatrix *create_chunked_matrix(const int width, const int height);
+
+ChunkedMatrix *destroy_chunked_matrix(ChunkedMatrix *matrix);
+
+/**
+ * Returns how many rigid bodies occupy the cell at (x, y).
+ */
+unsigned char chunked_matrix_get(const ChunkedMatrix *const matrix, const int x, const int y);
+
+/**
+ * Adds delta to all cells of the rectangle, allocating and freeing chunks as needed.
+ */
+void chunked_matrix_modify(ChunkedMatrix *matrix, int x, int y, int w, int h, const int delta);
+
+/**
+ * Evaluates whether or not all cells of the rectangle are free.
+ */
+int chunked_matrix_is_free(const ChunkedMatrix *const matrix, int x, int y, int w, int h);
+
+/**
+ * Returns the leftmost column of the rectangle with an occupied cell, or x + w if all of its cells are free.
+ */
+int chunked_matrix_find_first(const ChunkedMatrix *const matrix, int x, int y, int w, int h);
+
+/**
+ * Returns the rightmost column of the rectangle with an occupied cell, or x - 1 if all of its cells are free.
+ */
+int chunked_matrix_find_last(const ChunkedMatrix *const matrix, int x, int y, int w, int h);
+
+/**
+ * Returns how many chunks are currently allocated.
+ */
+size_t chunked_matrix_count_chunks(const ChunkedMatrix *const matrix);
+
+#endif
@@ -1,29 +1,91 @@
+#ifndef _WIN32
+/* Exposes clock_gettime and nanosleep, which are not part of ANSI C. */
+#define _POSIX_C_SOURCE 199309L
+#endif
+
 #include "clock.h"
 
-#include <SDL.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <time.h>
+#endif
+
+/**
+ * How long before a deadline sleeping stops and busy waiting starts.
+ */
+#define SPIN_NANOSECONDS (2 * NANOSECONDS_PER_MILLISECOND)
 
 /**
  * Returns a number of milliseconds.
  *
  * This function should be used to measure computation times.
  */
-Milliseconds get_milliseconds(void) { return SDL_GetTicks(); }
+Milliseconds get_milliseconds(void) { return (Milliseconds)(get_nanoseconds() / NANOSECONDS_PER_MILLISECOND); }
 
 /**
  * Sleeps for the specified number of milliseconds or more.
  */
 void sleep_milliseconds(Milliseconds amount) {
+#ifdef _WIN32
   /* The biggest value representable by long on all platforms. */
   const Milliseconds maximum_sleep = 0x7FFFFFFFL;
-  Uint32 ms;
   if (amount < 1) {
     return;
   }
-  if (amount < maximum_sleep) {
-    ms = (Uint32)amount;
-  } else {
-    /* Note that this constant is unsigned. */
-    ms = 0x7FFFFFFFUL;
+  Sleep((DWORD)(amount < maximum_sleep ? amount : maximum_sleep));
+#else
+  struct timespec duration;
+  if (amount < 1) {
+    return;
+  }
+  duration.tv_sec = amount / 1000;
+  duration.tv_nsec = (long)(amount % 1000) * NANOSECONDS_PER_MILLISECOND;
+  /* Keep sleeping for what is left if a signal interrupts the sleep. */
+  while (nanosleep(&duration, &duration) == -1 && errno == EINTR) {
+  }
+#endif
+}
+
+/**
+ * Returns a number of nanoseconds from a monotonic clock with the best resolution available.
+ *
+ * This function should be used to pace the game, as milliseconds are too coarse for short frames.
+ */
+Nanoseconds get_nanoseconds(void) {
+#ifdef _WIN32
+  LARGE_INTEGER frequency;
+  LARGE_INTEGER counter;
+  Nanoseconds seconds;
+  Nanoseconds rest;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  /* Convert whole seconds and the rest separately, as multiplying the counter first would overflow in seconds. */
+  seconds = (Nanoseconds)(counter.QuadPart / frequency.QuadPart);
+  rest = (Nanoseconds)(counter.QuadPart % frequency.QuadPart);
+  return seconds * NANOSECONDS_PER_SECOND + rest * NANOSECONDS_PER_SECOND / (Nanoseconds)frequency.QuadPart;
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (Nanoseconds)now.tv_sec * NANOSECONDS_PER_SECOND + now.tv_nsec;
+#endif
+}
+
+/**
+ * Waits until get_nanoseconds reaches the deadline, returning immediately if it already did.
+ *
+ * The thread sleeps while the deadline is far away and busy waits through the last stretch, as sleeping may overshoot
+ * by about a millisecond. Pacing against absolute deadlines rather than relative delays keeps overshoots from adding
+ * up over time.
+ */
+void sleep_until(const Nanoseconds deadline) {
+  Nanoseconds now = get_nanoseconds();
+  while (now + SPIN_NANOSECONDS < deadline) {
+    sleep_milliseconds((Milliseconds)((deadline - now - SPIN_NANOSECONDS) / NANOSECONDS_PER_MILLISECOND));
+    now = get_nanoseconds();
+  }
+  while (now < deadline) {
+    now = get_nanoseconds();
   }
-  SDL_Delay(ms);
 }
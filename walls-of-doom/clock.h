@@ -1,8 +1,27 @@
 #ifndef CLOCK_H
 #define CLOCK_H
 
+#include <limits.h>
+
 typedef unsigned long Milliseconds;
 
+/**
+ * A number of nanoseconds, which does not overflow for centuries.
+ *
+ * This needs 64 bits. C89 has no such type where long has 32 bits, so those compilers' own 64-bit types are used.
+ */
+#if ULONG_MAX > 0xFFFFFFFFUL
+typedef unsigned long Nanoseconds;
+#elif defined(_MSC_VER)
+typedef unsigned __int64 Nanoseconds;
+#else
+/* GCC and Clang accept long long in C89 as an extension, which __extension__ keeps -pedantic quiet about. */
+__extension__ typedef unsigned long long Nanoseconds;
+#endif
+
+#define NANOSECONDS_PER_MILLISECOND 1000000
+#define NANOSECONDS_PER_SECOND 1000000000
+
 /**
  * Returns a number of milliseconds.
  *
@@ -15,4 +34,20 @@ Milliseconds get_milliseconds(void);
  */
 void sleep_milliseconds(Milliseconds amount);
 
+/**
+ * Returns a number of nanoseconds from a monotonic clock with the best resolution available.
+ *
+ * This function should be used to pace the game, as milliseconds are too coarse for short frames.
+ */
+Nanoseconds get_nanoseconds(void);
+
+/**
+ * Waits until get_nanoseconds reaches the deadline, returning immediately if it already did.
+ *
+ * The thread sleeps while the deadline is far away and busy waits through the last stretch, as sleeping may overshoot
+ * by about a millisecond. Pacing against absolute deadlines rather than relative delays keeps overshoots from adding
+ * up over time.
+ */
+void sleep_until(const Nanoseconds deadline);
+
 #endif
@@ -1,5 +1,4 @@
 #include "color.h"
-#include <SDL.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -67,15 +66,6 @@ Color mix_colors(Color a, Color b) {
   return a;
 }
 
-SDL_Color to_sdl_color(Color color) {
-  SDL_Color sdl_color;
-  sdl_color.r = color.r;
-  sdl_color.g = color.g;
-  sdl_color.b = color.b;
-  sdl_color.a = color.a;
-  return sdl_color;
-}
-
 ColorPair color_pair_from_colors(Color foreground, Color background) {
   ColorPair pair;
   pair.foreground = foreground;
@@ -1,8 +1,6 @@
 #ifndef COLOR_H
 #define COLOR_H
 
-#include <SDL.h>
-
 typedef struct Color {
   unsigned char r;
   unsigned char g;
@@ -31,7 +29,6 @@ int color_equals(Color a, Color b);
 
 int color_pair_equals(ColorPair a, ColorPair b);
 
-SDL_Color to_sdl_color(Color color);
 Color color_from_rgb(unsigned char r, unsigned char g, unsigned char b);
 Color mix_colors(Color a, Color b);
 ColorPair color_pair_from_colors(Color foreground, Color background);
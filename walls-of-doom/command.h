@@ -2,7 +2,6 @@
 #define COMMAND_H
 
 #include "clock.h"
-#include "code.h"
 
 /**
  * The Command enumeration represents the different commands the user may issue.
@@ -31,15 +30,23 @@ typedef struct CommandTable {
   Milliseconds last_modified[COMMAND_COUNT];
 } CommandTable;
 
+/**
+ * A change to the status of a command, stamped with the time the user made it.
+ *
+ * Joystick axis motion changes both commands of an axis at once, so these events hold the command of the positive
+ * direction of the axis (right or down) and a value from -1 to 1.
+ */
+typedef struct InputEvent {
+  Command command;
+  double value;
+  int axis;
+  Milliseconds time;
+} InputEvent;
+
 void initialize_command_table(CommandTable *table);
 
 int test_command_table(CommandTable *table, enum Command command, Milliseconds repetition_delay);
 
-void read_commands(CommandTable *table);
-
-/**
- * Waits for any user input, blocking indefinitely.
- */
-Code wait_for_input(CommandTable *table);
+void apply_input_event(CommandTable *table, const InputEvent *const event);
 
 #endif
@@ -0,0 +1,8 @@
+#include "engine.h"
+#include <stdlib.h>
+
+void initialize_engine(Engine *engine, const RandomState random) {
+  engine->random = random;
+  engine->profiler = NULL;
+  engine->logging = 0;
+}
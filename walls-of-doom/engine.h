@@ -0,0 +1,27 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include "profiler.h"
+#include "random.h"
+
+/**
+ * Everything a game changes while it is simulated which is not part of the Game itself.
+ *
+ * Games with engines of their own share nothing which changes while they are simulated, so they can be simulated on
+ * different threads at the same time. Settings are shared, but they are only read while games are simulated, so they
+ * should not be changed while any game is.
+ */
+typedef struct Engine {
+  RandomState random;
+  /* Where the game is profiled, or NULL if it is not profiled. */
+  Profiler *profiler;
+  /* Whether the game writes to the logs, which only one game at a time should do. */
+  int logging;
+} Engine;
+
+/**
+ * Initializes an engine with a PRNG starting at the provided state, no profiler and no logging.
+ */
+void initialize_engine(Engine *engine, const RandomState random);
+
+#endif
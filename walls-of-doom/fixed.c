@@ -0,0 +1,51 @@
+#include "fixed.h"
+
+/**
+ * Converts an integer to a Fixed.
+ */
+Fixed integer_to_fixed(const int integer) { return (Fixed)integer * FIXED_ONE; }
+
+/**
+ * Converts a proportion in [-1, 1], such as an analog input, to the closest Fixed which is not further from zero.
+ */
+Fixed proportion_to_fixed(const double proportion) {
+  /* This is the only floating-point operation, and it happens once per input rather than once per frame. */
+  return (Fixed)(proportion * FIXED_ONE);
+}
+
+/**
+ * Returns the largest integer which is not bigger than the quotient of the provided numbers.
+ *
+ * Unlike the division operator, this rounds negative quotients towards negative infinity on every compiler.
+ */
+long floor_divide(const long numerator, const long denominator) {
+  long quotient;
+  if (denominator < 0) {
+    return floor_divide(-numerator, -denominator);
+  }
+  /* Only divide nonnegative numbers, as C89 leaves the rounding of negative quotients to the implementation. */
+  if (numerator >= 0) {
+    return numerator / denominator;
+  }
+  quotient = -numerator / denominator;
+  if (quotient * denominator != -numerator) {
+    quotient++;
+  }
+  return -quotient;
+}
+
+/**
+ * Advances a position by one frame at the provided speed, in fixed-point units per second.
+ *
+ * The remainder holds how far past the position the object is, in units of 1 / (FIXED_ONE * frames_per_second), and
+ * is always in [0, FIXED_ONE * frames_per_second). Returns how many whole units the position should move. As the
+ * remainder is exact, no movement is ever lost to rounding, however slow the speed is.
+ */
+int advance_fixed(long *remainder, const Fixed speed, const int frames_per_second) {
+  const long denominator = FIXED_ONE * frames_per_second;
+  long movement;
+  *remainder += speed;
+  movement = floor_divide(*remainder, denominator);
+  *remainder -= movement * denominator;
+  return (int)movement;
+}
@@ -0,0 +1,42 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+/**
+ * A signed 24.8 fixed-point number.
+ *
+ * The lowest FIXED_FRACTION_BITS bits hold the fractional part, so values are multiples of 1 / FIXED_ONE. All
+ * arithmetic on these numbers uses integers only, so it produces the same results on every compiler and architecture.
+ */
+typedef long Fixed;
+
+#define FIXED_FRACTION_BITS 8
+
+#define FIXED_ONE (1L << FIXED_FRACTION_BITS)
+
+/**
+ * Converts an integer to a Fixed.
+ */
+Fixed integer_to_fixed(const int integer);
+
+/**
+ * Converts a proportion in [-1, 1], such as an analog input, to the closest Fixed which is not further from zero.
+ */
+Fixed proportion_to_fixed(const double proportion);
+
+/**
+ * Returns the largest integer which is not bigger than the quotient of the provided numbers.
+ *
+ * Unlike the division operator, this rounds negative quotients towards negative infinity on every compiler.
+ */
+long floor_divide(const long numerator, const long denominator);
+
+/**
+ * Advances a position by one frame at the provided speed, in fixed-point units per second.
+ *
+ * The remainder holds how far past the position the object is, in units of 1 / (FIXED_ONE * frames_per_second), and
+ * is always in [0, FIXED_ONE * frames_per_second). Returns how many whole units the position should move. As the
+ * remainder is exact, no movement is ever lost to rounding, however slow the speed is.
+ */
+int advance_fixed(long *remainder, const Fixed speed, const int frames_per_second);
+
+#endif
@@ -0,0 +1,215 @@
+#include "game-loop.h"
+#include "clock.h"
+#include "constants.h"
+#include "high-io.h"
+#include "input-queue.h"
+#include "input.h"
+#include "logger.h"
+#include "record.h"
+#include "settings.h"
+#include <stdio.h>
+
+#define MAXIMUM_CATCH_UP_NANOSECONDS (250 * NANOSECONDS_PER_MILLISECOND)
+
+static void print_game_result(const Player *player, const int position, SDL_Renderer *renderer) {
+  const char *name = player->name;
+  const Score score = player->score;
+  const ColorPair color = COLOR_PAIR_DEFAULT;
+  char first_line[MAXIMUM_STRING_SIZE];
+  char second_line[MAXIMUM_STRING_SIZE];
+  char *lines[3];
+  lines[0] = first_line;
+  lines[1] = "";
+  lines[2] = second_line;
+  sprintf(first_line, "%s died after making %ld points.", name, score);
+  if (position > 0) {
+    sprintf(second_line, "%s got to position %d!", name, position);
+  } else {
+    sprintf(second_line, "%s didn't make it to the top scores.", name);
+  }
+  clear(renderer);
+  print_centered_vertically(3, lines, color, renderer);
+  present(renderer);
+}
+
+void register_score(const Game *const game, SDL_Renderer *renderer) {
+  const Player *const player = game->player;
+  char buffer[MAXIMUM_STRING_SIZE];
+  const char *format = "Started registering a score of %d points for %s.";
+  Record record;
+  int scoreboard_index;
+  int position;
+  sprintf(buffer, format, player->score, player->name, renderer);
+  log_message(buffer);
+  record = make_record(player->name, player->score);
+  scoreboard_index = save_record(&record);
+  position = scoreboard_index + 1;
+  log_message("Saved the record successfully.");
+  print_game_result(player, position, renderer);
+  wait_for_input(game->player->table);
+}
+
+/**
+ * Returns the time, as reported by get_milliseconds, at which the next frame ends.
+ *
+ * The time is computed from what is left in the accumulator after simulating the frame.
+ */
+static Milliseconds get_frame_end(const Milliseconds now, const Nanoseconds accumulator, const Nanoseconds tick_rate) {
+  const Nanoseconds lag = accumulator / tick_rate / NANOSECONDS_PER_MILLISECOND;
+  return lag < now ? now - (Milliseconds)lag : 0;
+}
+
+/**
+ * Runs the main game loop for the Game object and registers the player score.
+ *
+ * Frames are simulated at the tick rate, while drawing happens at most at the render rate. Elapsed time accumulates
+ * and is simulated in whole frames, so after a slow iteration the game catches up instead of slowing down, and what
+ * is left of a frame decides how far between the last two frames the game is drawn.
+ *
+ * Input is read right before simulating each frame, and each frame only applies the input made up to its end.
+ *
+ * If the ReplayWriter is not NULL, the game is recorded to it.
+ */
+Code run_game(Game *const game, ReplayWriter *replay, SDL_Renderer *renderer) {
+  const Nanoseconds tick_rate = get_tick_rate();
+  const Nanoseconds render_rate = get_render_rate();
+  /* Time which was not simulated yet, in units of 1 / tick_rate nanoseconds, so that each frame takes a second. */
+  Nanoseconds accumulator = 0;
+  Nanoseconds last_time = get_nanoseconds();
+  /* Drawings are due at fixed deadlines after this time, so that oversleeping once does not delay all later ones. */
+  Nanoseconds render_start = last_time;
+  Nanoseconds render_count = 0;
+  Nanoseconds deadline;
+  Nanoseconds elapsed;
+  Nanoseconds now;
+  Milliseconds now_milliseconds;
+  Fixed blend;
+  Code code = CODE_OK;
+  CommandTable *table = game->player->table;
+  InputQueue queue;
+  initialize_input_queue(&queue);
+  while (is_game_running(game)) {
+    now = get_nanoseconds();
+    now_milliseconds = get_milliseconds();
+    if (game->paused) {
+      draw_game(game, FIXED_ONE, renderer);
+      read_input_queue(&queue, table);
+      apply_input_queue(&queue, table, now_milliseconds);
+      if (test_command_table(table, COMMAND_CLOSE, REPETITION_DELAY)) {
+        code = CODE_CLOSE;
+      }
+      if (test_command_table(table, COMMAND_QUIT, REPETITION_DELAY)) {
+        code = CODE_QUIT;
+      }
+      if (test_command_table(table, COMMAND_PAUSE, REPETITION_DELAY)) {
+        game->paused = 0;
+      }
+      /* Time spent paused is never simulated. */
+      last_time = now;
+    } else {
+      elapsed = now - last_time;
+      /* Do not try to catch up on long stalls, such as the window being dragged, as that would freeze the game. */
+      if (elapsed > MAXIMUM_CATCH_UP_NANOSECONDS) {
+        elapsed = MAXIMUM_CATCH_UP_NANOSECONDS;
+      }
+      accumulator += elapsed * tick_rate;
+      last_time = now;
+      while (accumulator >= NANOSECONDS_PER_SECOND && is_game_running(game)) {
+        accumulator -= NANOSECONDS_PER_SECOND;
+        read_input_queue(&queue, table);
+        apply_input_queue(&queue, table, get_frame_end(now_milliseconds, accumulator, tick_rate));
+        if (replay != NULL) {
+          record_game_step(replay, game);
+        } else {
+          step_game(game, NULL, 0);
+        }
+      }
+      if (accumulator > NANOSECONDS_PER_SECOND) {
+        accumulator = NANOSECONDS_PER_SECOND;
+      }
+      blend = (Fixed)(accumulator * FIXED_ONE / NANOSECONDS_PER_SECOND);
+      draw_game(game, blend, renderer);
+      if (test_command_table(table, COMMAND_PAUSE, REPETITION_DELAY)) {
+        game->paused = 1;
+      }
+    }
+    render_count++;
+    deadline = render_start + render_count * NANOSECONDS_PER_SECOND / render_rate;
+    now = get_nanoseconds();
+    /* After falling more than a drawing behind, start over rather than drawing in a burst to catch up. */
+    if (deadline + NANOSECONDS_PER_SECOND / render_rate < now) {
+      render_start = now;
+      render_count = 0;
+      deadline = now;
+    }
+    sleep_until(deadline);
+  }
+  if (code != CODE_CLOSE) {
+    register_score(game, renderer);
+  }
+  if (code == CODE_QUIT) {
+    /* When the player quits from the game, it should go back to the menu. */
+    code = CODE_OK;
+  }
+  return code;
+}
+
+/**
+ * Plays a replay in the Game object, which should have been created right after the ReplayReader.
+ *
+ * Frames are simulated at the tick rate, or as fast as possible if unlimited is not zero, in which case the game is
+ * simulated for as long as a drawing lasts between drawings. The replay ends when it runs out of frames or when the
+ * user quits, which does not reach the game, as it only follows the recorded input.
+ */
+Code run_replay(Game *const game, ReplayReader *replay, const int unlimited, SDL_Renderer *renderer) {
+  const Nanoseconds tick_rate = get_tick_rate();
+  const Nanoseconds render_interval = NANOSECONDS_PER_SECOND / get_render_rate();
+  const Nanoseconds start = get_nanoseconds();
+  Nanoseconds accumulator = 0;
+  Nanoseconds last_time = start;
+  Nanoseconds elapsed;
+  Nanoseconds now = start;
+  Fixed blend = FIXED_ONE;
+  Code code = CODE_OK;
+  CommandTable controls;
+  char buffer[MAXIMUM_STRING_SIZE];
+  int running = 1;
+  initialize_command_table(&controls);
+  while (running && code == CODE_OK) {
+    if (unlimited) {
+      do {
+        running = replay_game_step(replay, game);
+      } while (running && get_nanoseconds() - now < render_interval);
+    } else {
+      elapsed = now - last_time;
+      if (elapsed > MAXIMUM_CATCH_UP_NANOSECONDS) {
+        elapsed = MAXIMUM_CATCH_UP_NANOSECONDS;
+      }
+      accumulator += elapsed * tick_rate;
+      last_time = now;
+      while (accumulator >= NANOSECONDS_PER_SECOND && running) {
+        accumulator -= NANOSECONDS_PER_SECOND;
+        running = replay_game_step(replay, game);
+      }
+      if (accumulator > NANOSECONDS_PER_SECOND) {
+        accumulator = NANOSECONDS_PER_SECOND;
+      }
+      blend = (Fixed)(accumulator * FIXED_ONE / NANOSECONDS_PER_SECOND);
+    }
+    draw_game(game, blend, renderer);
+    read_commands(&controls);
+    if (test_command_table(&controls, COMMAND_CLOSE, REPETITION_DELAY)) {
+      code = CODE_CLOSE;
+    } else if (test_command_table(&controls, COMMAND_QUIT, REPETITION_DELAY)) {
+      code = CODE_QUIT;
+    }
+    if (!unlimited) {
+      sleep_until(now + render_interval);
+    }
+    now = get_nanoseconds();
+  }
+  elapsed = (now - start) / NANOSECONDS_PER_MILLISECOND;
+  sprintf(buffer, "Replayed %lu frames in %lu ms.", game->frame, (unsigned long)elapsed);
+  log_message(buffer);
+  return code;
+}
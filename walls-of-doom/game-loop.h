@@ -0,0 +1,23 @@
+#ifndef GAME_LOOP_H
+#define GAME_LOOP_H
+
+#include "code.h"
+#include "game.h"
+#include "replay.h"
+#include <SDL.h>
+
+/**
+ * Runs the main game loop for the Game object and registers the player score.
+ *
+ * If the ReplayWriter is not NULL, the game is recorded to it.
+ */
+Code run_game(Game *const game, ReplayWriter *replay, SDL_Renderer *renderer);
+
+/**
+ * Plays a replay in the Game object, which should have been created right after the ReplayReader.
+ *
+ * Frames are simulated at the tick rate, or as fast as possible if unlimited is not zero.
+ */
+Code run_replay(Game *const game, ReplayReader *replay, const int unlimited, SDL_Renderer *renderer);
+
+#endif
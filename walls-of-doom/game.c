@@ -1,25 +1,20 @@
 #include "game.h"
-#include "about.h"
 #include "box.h"
 #include "constants.h"
 #include "data.h"
-#include "high-io.h"
 #include "logger.h"
 #include "memory.h"
-#include "menu.h"
 #include "physics.h"
 #include "profiler.h"
 #include "random.h"
-#include "record.h"
+#include "state-hash.h"
 #include "text.h"
-#include "version.h"
-#include <SDL.h>
 #include <stdlib.h>
 #include <string.h>
 
 #define DEFAULT_LIMIT_PLAYED_MINUTES 2
 #define DEFAULT_LIMIT_PLAYED_SECONDS (DEFAULT_LIMIT_PLAYED_MINUTES * 60)
-#define DEFAULT_LIMIT_PLAYED_FRAMES DEFAULT_LIMIT_PLAYED_SECONDS *FPS
+#define DEFAULT_LIMIT_PLAYED_FRAMES (DEFAULT_LIMIT_PLAYED_SECONDS * get_tick_rate())
 
 void print_command_table(CommandTable *table);
 
@@ -31,61 +26,544 @@ static size_t get_rigid_matrix_index(const Game *const game, const int x, const
   return base_x + base_y * game->rigid_matrix_n;
 }
 
+/**
+ * Clips the rectangle to the bounding box, returning 0 if nothing is left of it.
+ */
+static int clip_to_box(const BoundingBox *const box, int *x, int *y, int *w, int *h) {
+  if (*x < box->min_x) {
+    *w -= box->min_x - *x;
+    *x = box->min_x;
+  }
+  if (*y < box->min_y) {
+    *h -= box->min_y - *y;
+    *y = box->min_y;
+  }
+  if (*x + *w - 1 > box->max_x) {
+    *w = box->max_x - *x + 1;
+  }
+  if (*y + *h - 1 > box->max_y) {
+    *h = box->max_y - *y + 1;
+  }
+  return *w > 0 && *h > 0;
+}
+
 unsigned char get_from_rigid_matrix(const Game *const game, const int x, const int y) {
+  const int base_x = x - game->box->min_x;
+  const int base_y = y - game->box->min_y;
+  if (game->collision_backend == COLLISION_BACKEND_PACKED) {
+    return packed_matrix_get(game->packed_matrix, base_x, base_y);
+  }
+  if (game->collision_backend == COLLISION_BACKEND_SPANS) {
+    return span_table_get(game->span_table, base_x, base_y);
+  }
+  if (game->collision_backend == COLLISION_BACKEND_CHUNKED) {
+    return chunked_matrix_get(game->chunked_matrix, base_x, base_y);
+  }
   if (bounding_box_contains(game->box, x, y)) {
     return game->rigid_matrix[get_rigid_matrix_index(game, x, y)];
   }
   return 0;
 }
 
-void modify_rigid_matrix_point(const Game *const game, const int x, const int y, const unsigned char delta) {
-  if (bounding_box_contains(game->box, x, y)) {
-    game->rigid_matrix[get_rigid_matrix_index(game, x, y)] += delta;
+static void modify_dense_region(const Game *const game, int x, int y, int w, int h, const int delta) {
+  unsigned char *row;
+  int i;
+  int j;
+  if (!clip_to_box(game->box, &x, &y, &w, &h)) {
+    return;
+  }
+  for (j = y; j < y + h; j++) {
+    row = game->rigid_matrix + get_rigid_matrix_index(game, x, j);
+    for (i = 0; i < w; i++) {
+      row[i] += delta;
+    }
+  }
+}
+
+static void modify_chunked_region(const Game *const game, const int x, const int y, const int w, const int h,
+                                  const int delta) {
+  chunked_matrix_modify(game->chunked_matrix, x - game->box->min_x, y - game->box->min_y, w, h, delta);
+}
+
+static void fill_packed_region(const Game *const game, const int x, const int y, const int w, const int h,
+                               const int value) {
+  const int base_x = x - game->box->min_x;
+  const int base_y = y - game->box->min_y;
+  packed_matrix_fill(game->packed_matrix, base_x, base_y, w, h, value);
+}
+
+/**
+ * Marks again the parts of the rectangle which are covered by platforms other than the owner.
+ *
+ * The packed matrix cannot count how many rigid bodies occupy a cell, so after clearing a region this restores the
+ * cells of any platforms which overlap it.
+ */
+static void restore_overlapping_platforms(const Game *const game, const Platform *owner, int x, int y, int w, int h) {
+  const Platform *other;
+  int min_x;
+  int min_y;
+  int max_x;
+  int max_y;
+  int row;
+  /* Platforms are a single row tall, so only the rows of the region need to be searched. */
+  for (row = get_platform_row(game, y); row <= get_platform_row(game, y + h - 1); row++) {
+    for (other = get_first_platform_in_row(game, row); other != NULL; other = get_next_platform_in_row(game, other)) {
+      if (other != owner) {
+        min_x = max_int(x, other->x);
+        min_y = max_int(y, other->y);
+        max_x = min_int(x + w, other->x + other->w);
+        max_y = min_int(y + h, other->y + other->h);
+        if (min_x < max_x && min_y < max_y) {
+          fill_packed_region(game, min_x, min_y, max_x - min_x, max_y - min_y, 1);
+        }
+      }
+    }
+  }
+}
+
+static void modify_span_region(const Game *const game, const int x, const int y, const int w, const int h,
+                               const int delta) {
+  const int base_x = x - game->box->min_x;
+  const int base_y = y - game->box->min_y;
+  int i;
+  for (i = 0; i < delta; i++) {
+    span_table_add(game->span_table, base_x, base_y, w, h);
+  }
+  for (i = 0; i > delta; i--) {
+    span_table_remove(game->span_table, base_x, base_y, w, h);
+  }
+}
+
+/**
+ * Adds delta to the rectangle, which belongs to the owner Platform.
+ */
+static void modify_rigid_matrix_region(const Game *const game, const Platform *owner, const int x, const int y,
+                                       const int w, const int h, const int delta) {
+  if (game->collision_backend == COLLISION_BACKEND_SPANS) {
+    modify_span_region(game, x, y, w, h, delta);
+  } else if (game->collision_backend == COLLISION_BACKEND_PACKED) {
+    if (delta > 0) {
+      fill_packed_region(game, x, y, w, h, 1);
+    } else if (delta < 0) {
+      fill_packed_region(game, x, y, w, h, 0);
+      restore_overlapping_platforms(game, owner, x, y, w, h);
+    }
+  } else if (game->collision_backend == COLLISION_BACKEND_CHUNKED) {
+    modify_chunked_region(game, x, y, w, h, delta);
+  } else {
+    modify_dense_region(game, x, y, w, h, delta);
+  }
+}
+
+void modify_rigid_matrix_platform(Game *game, Platform const *platform, const int delta) {
+  modify_rigid_matrix_region(game, platform, platform->x, platform->y, platform->w, platform->h, delta);
+}
+
+/**
+ * Updates the rigid matrix for a horizontal move of the platform by dx.
+ *
+ * Only the columns the platform vacates and the columns it starts to cover are written. The platform itself is not
+ * changed and should still be at its old position.
+ */
+void shift_rigid_matrix_platform(Game *game, Platform const *platform, const int dx) {
+  const int x = platform->x;
+  const int y = platform->y;
+  const int w = platform->w;
+  const int h = platform->h;
+  if (abs(dx) >= w) {
+    /* The old and the new rectangles do not overlap. */
+    modify_rigid_matrix_region(game, platform, x, y, w, h, -1);
+    modify_rigid_matrix_region(game, platform, x + dx, y, w, h, 1);
+  } else if (dx > 0) {
+    modify_rigid_matrix_region(game, platform, x, y, dx, h, -1);
+    modify_rigid_matrix_region(game, platform, x + w, y, dx, h, 1);
+  } else if (dx < 0) {
+    modify_rigid_matrix_region(game, platform, x + w + dx, y, -dx, h, -1);
+    modify_rigid_matrix_region(game, platform, x + dx, y, -dx, h, 1);
+  }
+}
+
+/**
+ * Evaluates whether or not the rectangle starting at (x, y) is free of rigid bodies.
+ *
+ * Positions outside of the bounding box are always free.
+ */
+int is_rigid_matrix_region_free(const Game *const game, int x, int y, int w, int h) {
+  const unsigned char *row;
+  int i;
+  int j;
+  if (game->collision_backend == COLLISION_BACKEND_PACKED) {
+    return packed_matrix_is_free(game->packed_matrix, x - game->box->min_x, y - game->box->min_y, w, h);
+  }
+  if (game->collision_backend == COLLISION_BACKEND_SPANS) {
+    return span_table_is_free(game->span_table, x - game->box->min_x, y - game->box->min_y, w, h);
+  }
+  if (game->collision_backend == COLLISION_BACKEND_CHUNKED) {
+    return chunked_matrix_is_free(game->chunked_matrix, x - game->box->min_x, y - game->box->min_y, w, h);
+  }
+  if (!clip_to_box(game->box, &x, &y, &w, &h)) {
+    return 1;
+  }
+  /* Traverse the matrix in storage order. */
+  for (j = y; j < y + h; j++) {
+    row = game->rigid_matrix + get_rigid_matrix_index(game, x, j);
+    for (i = 0; i < w; i++) {
+      if (row[i]) {
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+/**
+ * Returns the leftmost occupied column of the rectangle, or x + w if it is free.
+ */
+static int find_first_dense_column(const Game *const game, int x, int y, int w, int h) {
+  const int none = x + w;
+  const unsigned char *row;
+  int found;
+  int i;
+  int j;
+  if (!clip_to_box(game->box, &x, &y, &w, &h)) {
+    return none;
+  }
+  found = w;
+  for (j = y; j < y + h && found > 0; j++) {
+    row = game->rigid_matrix + get_rigid_matrix_index(game, x, j);
+    for (i = 0; i < found; i++) {
+      if (row[i]) {
+        found = i;
+        break;
+      }
+    }
+  }
+  return found == w ? none : x + found;
+}
+
+/**
+ * Returns the rightmost occupied column of the rectangle, or x - 1 if it is free.
+ */
+static int find_last_dense_column(const Game *const game, int x, int y, int w, int h) {
+  const int none = x - 1;
+  const unsigned char *row;
+  int found;
+  int i;
+  int j;
+  if (!clip_to_box(game->box, &x, &y, &w, &h)) {
+    return none;
+  }
+  found = -1;
+  for (j = y; j < y + h && found < w - 1; j++) {
+    row = game->rigid_matrix + get_rigid_matrix_index(game, x, j);
+    for (i = w - 1; i > found; i--) {
+      if (row[i]) {
+        found = i;
+        break;
+      }
+    }
+  }
+  return found == -1 ? none : x + found;
+}
+
+/**
+ * Returns how many consecutive columns, starting at column x and advancing in the direction of dx, are free of rigid
+ * bodies in the h rows starting at y.
+ *
+ * At most abs(dx) columns are checked, so this is also the largest value this function returns.
+ */
+int get_rigid_matrix_free_columns(const Game *const game, const int x, const int y, const int h, const int dx) {
+  const int w = abs(dx);
+  const int min_x = dx < 0 ? x - w + 1 : x;
+  /* The packed matrix and the span table take coordinates relative to the bounding box. */
+  const int base_x = x - game->box->min_x;
+  const int base_min_x = min_x - game->box->min_x;
+  const int base_y = y - game->box->min_y;
+  if (dx > 0) {
+    if (game->collision_backend == COLLISION_BACKEND_PACKED) {
+      return packed_matrix_find_first(game->packed_matrix, base_min_x, base_y, w, h) - base_x;
+    }
+    if (game->collision_backend == COLLISION_BACKEND_SPANS) {
+      return span_table_find_first(game->span_table, base_min_x, base_y, w, h) - base_x;
+    }
+    if (game->collision_backend == COLLISION_BACKEND_CHUNKED) {
+      return chunked_matrix_find_first(game->chunked_matrix, base_min_x, base_y, w, h) - base_x;
+    }
+    return find_first_dense_column(game, min_x, y, w, h) - x;
+  }
+  if (dx < 0) {
+    if (game->collision_backend == COLLISION_BACKEND_PACKED) {
+      return base_x - packed_matrix_find_last(game->packed_matrix, base_min_x, base_y, w, h);
+    }
+    if (game->collision_backend == COLLISION_BACKEND_SPANS) {
+      return base_x - span_table_find_last(game->span_table, base_min_x, base_y, w, h);
+    }
+    if (game->collision_backend == COLLISION_BACKEND_CHUNKED) {
+      return base_x - chunked_matrix_find_last(game->chunked_matrix, base_min_x, base_y, w, h);
+    }
+    return x - find_last_dense_column(game, min_x, y, w, h);
+  }
+  return 0;
+}
+
+/**
+ * Returns how many consecutive rows, starting at row y and advancing in the direction of dy, are free of rigid bodies
+ * in the w columns starting at x.
+ *
+ * At most abs(dy) rows are checked, so this is also the largest value this function returns.
+ */
+int get_rigid_matrix_free_rows(const Game *const game, const int x, const int y, const int w, const int dy) {
+  const int step = dy < 0 ? -1 : 1;
+  int rows = 0;
+  while (rows < abs(dy) && is_rigid_matrix_region_free(game, x, y + step * rows, w, 1)) {
+    rows++;
+  }
+  return rows;
+}
+
+/**
+ * Returns whether or not the platform exactly covers a row of tiles of the platform index.
+ */
+static int is_platform_on_row(const Game *const game, Platform const *platform) {
+  const int row = get_platform_row(game, platform->y);
+  if (row < 0 || row >= game->platform_index->row_count || platform->h != game->tile_h) {
+    return 0;
   }
+  return platform->y == game->box->min_y + row * game->tile_h;
 }
 
-void modify_rigid_matrix_platform(Game *game, Platform const *platform, const unsigned char delta) {
-  int x;
+/**
+ * Adds all platforms which exactly cover a row of tiles to the dense rigid matrix, which should be empty.
+ *
+ * The platforms of each row are accumulated into a difference array, so each row is written once no matter how many
+ * platforms overlap in it, and its first line of pixels is copied to the others.
+ */
+static void rasterize_dense_platforms(Game *game) {
+  const int n = game->rigid_matrix_n;
+  const int m = game->rigid_matrix_m;
+  int *differences = resize_memory(NULL, sizeof(int) * (n + 1));
+  const Platform *platform;
+  unsigned char *first;
+  int coverage;
+  int min_x;
+  int max_x;
+  int row;
   int y;
-  for (x = 0; x < platform->w; ++x) {
-    for (y = 0; y < platform->h; ++y) {
-      modify_rigid_matrix_point(game, platform->x + x, platform->y + y, delta);
+  int i;
+  for (row = 0; row < game->platform_index->row_count; row++) {
+    if (get_first_platform_in_row(game, row) == NULL) {
+      continue;
+    }
+    memset(differences, 0, sizeof(int) * (n + 1));
+    for (platform = get_first_platform_in_row(game, row); platform != NULL;
+         platform = get_next_platform_in_row(game, platform)) {
+      min_x = max_int(platform->x - game->box->min_x, 0);
+      max_x = min_int(platform->x + platform->w - game->box->min_x, n);
+      if (is_platform_on_row(game, platform) && min_x < max_x) {
+        differences[min_x]++;
+        differences[max_x]--;
+      }
+    }
+    y = row * game->tile_h;
+    first = game->rigid_matrix + (size_t)y * n;
+    coverage = 0;
+    for (i = 0; i < n; i++) {
+      coverage += differences[i];
+      first[i] = (unsigned char)coverage;
+    }
+    for (y = y + 1; y < min_int((row + 1) * game->tile_h, m); y++) {
+      memcpy(game->rigid_matrix + (size_t)y * n, first, n);
     }
   }
+  resize_memory(differences, 0);
 }
 
 static void initialize_rigid_matrix(Game *game) {
   size_t i;
-  memset(game->rigid_matrix, 0, game->rigid_matrix_size);
+  game->rigid_matrix = NULL;
+  game->packed_matrix = NULL;
+  game->span_table = NULL;
+  game->chunked_matrix = NULL;
+  if (game->collision_backend == COLLISION_BACKEND_PACKED) {
+    game->packed_matrix = create_packed_matrix(game->rigid_matrix_n, game->rigid_matrix_m);
+  } else if (game->collision_backend == COLLISION_BACKEND_SPANS) {
+    game->span_table = create_span_table(game->rigid_matrix_n, game->rigid_matrix_m, game->tile_h);
+  } else if (game->collision_backend == COLLISION_BACKEND_CHUNKED) {
+    game->chunked_matrix = create_chunked_matrix(game->rigid_matrix_n, game->rigid_matrix_m);
+  } else {
+    game->rigid_matrix = resize_memory(NULL, sizeof(unsigned char) * game->rigid_matrix_size);
+    memset(game->rigid_matrix, 0, game->rigid_matrix_size);
+    rasterize_dense_platforms(game);
+  }
   for (i = 0; i < game->platform_count; i++) {
-    modify_rigid_matrix_platform(game, game->platforms + i, 1);
+    if (game->rigid_matrix == NULL || !is_platform_on_row(game, game->platforms + i)) {
+      modify_rigid_matrix_platform(game, game->platforms + i, 1);
+    }
+  }
+}
+
+/**
+ * Returns the row of tiles which contains the provided y coordinate, or -1 if it is above the bounding box.
+ */
+int get_platform_row(const Game *const game, const int y) {
+  if (y < game->box->min_y) {
+    return -1;
   }
+  return (y - game->box->min_y) / game->tile_h;
+}
+
+/**
+ * Updates the platform index after the platform changed rows.
+ */
+void reindex_platform(Game *game, Platform const *platform) {
+  platform_index_set_row(game->platform_index, platform - game->platforms, get_platform_row(game, platform->y));
+}
+
+/**
+ * Removes the platform from the platform index until it is reindexed.
+ */
+void unindex_platform(Game *game, Platform const *platform) {
+  platform_index_set_row(game->platform_index, platform - game->platforms, -1);
+}
+
+/**
+ * Copies the state of the platform to the platform store after it moved.
+ *
+ * This is called on the threads updating the platforms, so it does not touch the movement table, which may grow. The
+ * speed of the platform must not have changed, as its row of the movement table is kept.
+ */
+void mirror_platform(Game *game, Platform const *platform) {
+  platform_store_set(game->platform_store, platform - game->platforms, platform);
+}
+
+/**
+ * Copies the state of the platform to the platform store after its speed changed, finding the row of the movement
+ * table for the new speed.
+ *
+ * This may add a row to the movement table, so it must not be called while the platforms are updated.
+ */
+void mirror_platform_speed(Game *game, Platform const *platform) {
+  const size_t index = platform - game->platforms;
+  mirror_platform(game, platform);
+  game->platform_store->movement_row[index] = movement_table_find(game->movement_table, abs(platform->speed));
+}
+
+/**
+ * Remembers the current positions of the platforms and of the player as their positions before the next frame.
+ */
+void remember_positions(Game *game) {
+  memcpy(game->previous_x, game->platform_store->x, sizeof(int) * game->platform_count);
+  memcpy(game->previous_y, game->platform_store->y, sizeof(int) * game->platform_count);
+  game->previous_player_x = game->player->x;
+  game->previous_player_y = game->player->y;
+}
+
+/**
+ * Makes the platform appear at its current position until the next frame, instead of moving there from its previous
+ * position. This should be used when the platform was moved elsewhere rather than along its way.
+ */
+void forget_platform_position(Game *game, Platform const *platform) {
+  const size_t index = platform - game->platforms;
+  game->previous_x[index] = platform->x;
+  game->previous_y[index] = platform->y;
+}
+
+/**
+ * Makes the player appear at its current position until the next frame, instead of moving there from its previous
+ * position.
+ */
+void forget_player_position(Game *game) {
+  game->previous_player_x = game->player->x;
+  game->previous_player_y = game->player->y;
+}
+
+static Platform *get_indexed_platform(const Game *const game, const size_t platform) {
+  if (platform == PLATFORM_INDEX_NONE) {
+    return NULL;
+  }
+  return game->platforms + platform;
+}
+
+/**
+ * Returns the first platform in the row of tiles, or NULL if there is none.
+ */
+Platform *get_first_platform_in_row(const Game *const game, const int row) {
+  return get_indexed_platform(game, platform_index_first(game->platform_index, row));
+}
+
+/**
+ * Returns the platform after the provided one in its row of tiles, or NULL if it is the last one.
+ */
+Platform *get_next_platform_in_row(const Game *const game, Platform const *platform) {
+  return get_indexed_platform(game, platform_index_next(game->platform_index, platform - game->platforms));
+}
+
+static void initialize_platform_store(Game *game) {
+  size_t i;
+  game->platform_store = create_platform_store(game->platforms, game->platform_count);
+  for (i = 0; i < game->platform_count; i++) {
+    mirror_platform_speed(game, game->platforms + i);
+  }
+}
+
+static void initialize_platform_index(Game *game) {
+  const int row_count = (game->rigid_matrix_m + game->tile_h - 1) / game->tile_h;
+  size_t i;
+  game->platform_index = create_platform_index(row_count, game->platform_count);
+  for (i = 0; i < game->platform_count; i++) {
+    reindex_platform(game, game->platforms + i);
+  }
+}
+
+static void initialize_worker_pool(Game *game) {
+  const int row_count = game->platform_index->row_count;
+  int i;
+  game->worker_pool = NULL;
+  game->row_groups = NULL;
+  game->group_starts = NULL;
+  game->group_items = NULL;
+  game->player_group = -1;
+  /* Neighboring rows of tiles may share chunks, so the chunked backend cannot be updated in parallel. */
+  if (get_platform_threads() < 2 || game->collision_backend == COLLISION_BACKEND_CHUNKED) {
+    return;
+  }
+  game->worker_pool = create_worker_pool(get_platform_threads());
+  if (game->worker_pool == NULL) {
+    return;
+  }
+  game->row_groups = resize_memory(NULL, sizeof(int) * row_count);
+  for (i = 0; i < row_count; i++) {
+    game->row_groups[i] = -1;
+  }
+  game->group_starts = resize_memory(NULL, sizeof(size_t) * (row_count + 1));
+  game->group_items = resize_memory(NULL, sizeof(size_t) * game->platform_count);
 }
 
 static void initialize_bounding_box(Game *game) {
   game->box->min_x = 0;
   game->box->min_y = 0;
-  game->box->max_x = get_window_width();
-  game->box->max_y = get_window_height() - 2 * get_bar_height();
+  game->box->max_x = get_logical_width();
+  game->box->max_y = get_logical_height() - 2 * get_bar_height();
 }
 
 /**
  * Creates a new Game object with the provided objects.
  */
-Game create_game(Player *player) {
+Game create_game(Player *player, Engine *engine) {
   const int tile_w = get_tile_width();
   const int tile_h = get_tile_height();
   const int platform_count = get_platform_count();
-  size_t rigid_matrix_bytes;
   Game game;
 
   game.player = player;
+  game.engine = engine;
   game.platform_count = platform_count;
   game.platforms = resize_memory(NULL, sizeof(Platform) * platform_count);
 
   game.frame = 0;
   game.played_frames = 0;
   game.limit_played_frames = DEFAULT_LIMIT_PLAYED_FRAMES;
+  game.next_played_frames_score = get_tick_rate();
 
   game.paused = 0;
 
@@ -98,9 +576,18 @@ Game create_game(Player *player) {
   game.box = resize_memory(NULL, sizeof(BoundingBox));
   initialize_bounding_box(&game);
 
-  generate_platforms(game.platforms, game.box, platform_count, tile_w, tile_h);
+  generate_platforms(game.platforms, game.box, platform_count, tile_w, tile_h, &engine->random);
+  game.movement_table = create_movement_table(get_tick_rate());
+  initialize_platform_store(&game);
+  /* A platform moves at least once a second, so it never needs to be scheduled further ahead than that. */
+  game.platform_wheel = create_timing_wheel(get_tick_rate() + 1, platform_count);
+  game.collision_frames = resize_memory(NULL, sizeof(unsigned long) * platform_count);
+  game.previous_x = resize_memory(NULL, sizeof(int) * platform_count);
+  game.previous_y = resize_memory(NULL, sizeof(int) * platform_count);
+  schedule_platforms(&game);
 
   reposition_player(&game);
+  remember_positions(&game);
 
   game.perk = PERK_NONE;
   game.perk_x = 0;
@@ -111,15 +598,19 @@ Game create_game(Player *player) {
   game.rigid_matrix_m = game.box->max_y - game.box->min_y + 1;
   game.rigid_matrix_n = game.box->max_x - game.box->min_x + 1;
   game.rigid_matrix_size = game.rigid_matrix_m * game.rigid_matrix_n;
-  rigid_matrix_bytes = sizeof(unsigned char) * game.rigid_matrix_size;
-  game.rigid_matrix = resize_memory(NULL, rigid_matrix_bytes);
+  game.collision_backend = get_collision_backend();
+  /* The packed backend uses the platform index, so it must be built first. */
+  initialize_platform_index(&game);
   initialize_rigid_matrix(&game);
+  initialize_worker_pool(&game);
 
   game.message[0] = '\0';
   game.message_end_frame = 0;
   game.message_priority = 0;
 
-  log_message("Finished creating the game.");
+  if (engine->logging) {
+    log_message("Finished creating the game.");
+  }
 
   return game;
 }
@@ -127,20 +618,51 @@ Game create_game(Player *player) {
 void destroy_game(Game *game) {
   destroy_player(game->player);
   game->rigid_matrix = resize_memory(game->rigid_matrix, 0);
+  game->packed_matrix = destroy_packed_matrix(game->packed_matrix);
+  game->span_table = destroy_span_table(game->span_table);
+  game->chunked_matrix = destroy_chunked_matrix(game->chunked_matrix);
   game->box = resize_memory(game->box, 0);
+  game->platform_index = destroy_platform_index(game->platform_index);
+  game->platform_store = destroy_platform_store(game->platform_store);
+  game->movement_table = destroy_movement_table(game->movement_table);
+  game->platform_wheel = destroy_timing_wheel(game->platform_wheel);
+  game->collision_frames = resize_memory(game->collision_frames, 0);
+  game->previous_x = resize_memory(game->previous_x, 0);
+  game->previous_y = resize_memory(game->previous_y, 0);
+  game->worker_pool = destroy_worker_pool(game->worker_pool);
+  game->row_groups = resize_memory(game->row_groups, 0);
+  game->group_starts = resize_memory(game->group_starts, 0);
+  game->group_items = resize_memory(game->group_items, 0);
   game->platforms = resize_memory(game->platforms, 0);
 }
 
+/**
+ * Rebuilds everything derived from the platforms and from the frame, after they were replaced by a saved state.
+ */
+void rebuild_game(Game *game) {
+  game->platform_store = destroy_platform_store(game->platform_store);
+  game->platform_index = destroy_platform_index(game->platform_index);
+  game->rigid_matrix = resize_memory(game->rigid_matrix, 0);
+  game->packed_matrix = destroy_packed_matrix(game->packed_matrix);
+  game->span_table = destroy_span_table(game->span_table);
+  game->chunked_matrix = destroy_chunked_matrix(game->chunked_matrix);
+  initialize_platform_store(game);
+  initialize_platform_index(game);
+  initialize_rigid_matrix(game);
+  schedule_platforms(game);
+  remember_positions(game);
+}
+
 Milliseconds update_game(Game *const game) {
   Milliseconds game_update_start;
-  profiler_begin("update_game");
+  profiler_begin(game->engine->profiler, "update_game");
   game_update_start = get_milliseconds();
   if (game->message_end_frame < game->frame) {
     game->message[0] = '\0';
   }
   update_platforms(game);
   update_perk(game);
-  profiler_end("update_game");
+  profiler_end(game->engine->profiler, "update_game");
   return get_milliseconds() - game_update_start;
 }
 
@@ -156,104 +678,41 @@ void game_set_message(Game *const game, const char *message, const unsigned long
   const int last_has_expired = game->message_end_frame <= game->frame;
   const int last_has_lower_priority = game->message_priority <= priority;
   if (last_has_expired || last_has_lower_priority) {
-    game->message_end_frame = game->frame + duration * FPS;
+    game->message_end_frame = game->frame + duration * get_tick_rate();
     game->message_priority = priority;
     copy_string(game->message, message, MAXIMUM_STRING_SIZE);
   }
 }
 
-static void print_game_result(const Player *player, const int position, SDL_Renderer *renderer) {
-  const char *name = player->name;
-  const Score score = player->score;
-  const ColorPair color = COLOR_PAIR_DEFAULT;
-  char first_line[MAXIMUM_STRING_SIZE];
-  char second_line[MAXIMUM_STRING_SIZE];
-  char *lines[3];
-  lines[0] = first_line;
-  lines[1] = "";
-  lines[2] = second_line;
-  sprintf(first_line, "%s died after making %ld points.", name, score);
-  if (position > 0) {
-    sprintf(second_line, "%s got to position %d!", name, position);
-  } else {
-    sprintf(second_line, "%s didn't make it to the top scores.", name);
-  }
-  clear(renderer);
-  print_centered_vertically(3, lines, color, renderer);
-  present(renderer);
-}
-
-void register_score(const Game *const game, SDL_Renderer *renderer) {
-  const Player *const player = game->player;
-  char buffer[MAXIMUM_STRING_SIZE];
-  const char *format = "Started registering a score of %d points for %s.";
-  Record record;
-  int scoreboard_index;
-  int position;
-  sprintf(buffer, format, player->score, player->name, renderer);
-  log_message(buffer);
-  record = make_record(player->name, player->score);
-  scoreboard_index = save_record(&record);
-  position = scoreboard_index + 1;
-  log_message("Saved the record successfully.");
-  print_game_result(player, position, renderer);
-  wait_for_input(game->player->table);
+/**
+ * Evaluates whether or not the game should go on: the player did not quit, has lives left and did not reach the limit
+ * of played frames.
+ */
+int is_game_running(const Game *const game) {
+  const int quit = game->player->table->status[COMMAND_QUIT] != 0.0;
+  return !quit && game->player->lives != 0 && game->played_frames < game->limit_played_frames;
 }
 
 /**
- * Runs the main game loop for the Game object and registers the player score.
+ * Applies the input events to the command table of the player, in order, and simulates a single frame.
+ *
+ * This does not depend on any clock, so the game can be simulated as fast as the processor allows.
  */
-Code run_game(Game *const game, SDL_Renderer *renderer) {
-  unsigned long next_played_frames_score = FPS;
-  const Milliseconds interval = 1000 / FPS;
-  Milliseconds drawing_delta = 0;
-  Milliseconds updating_delta = 0;
-  Code code = CODE_OK;
-  int *lives = &game->player->lives;
-  unsigned long *played = &game->played_frames;
-  unsigned long limit = game->limit_played_frames;
-  CommandTable table;
-  initialize_command_table(&table);
-  while (!game->player->table->status[COMMAND_QUIT] && *lives != 0 && *played < limit) {
-    if (game->paused) {
-      drawing_delta = draw_game(game, renderer);
-      if (drawing_delta < interval) {
-        sleep_milliseconds(interval - drawing_delta);
-      }
-      read_commands(game->player->table);
-      if (test_command_table(game->player->table, COMMAND_CLOSE, REPETITION_DELAY)) {
-        code = CODE_CLOSE;
-      }
-      if (test_command_table(game->player->table, COMMAND_QUIT, REPETITION_DELAY)) {
-        code = CODE_QUIT;
-      }
-      if (test_command_table(game->player->table, COMMAND_PAUSE, REPETITION_DELAY)) {
-        game->paused = 0;
-      }
-      continue;
-    }
-    if (game->played_frames == next_played_frames_score) {
-      player_score_add(game->player, 1);
-      next_played_frames_score += FPS;
-    }
-    updating_delta = update_game(game);
-    drawing_delta = draw_game(game, renderer);
-    if (updating_delta + drawing_delta < interval) {
-      sleep_milliseconds(interval - updating_delta - drawing_delta);
-    }
-    read_commands(game->player->table);
-    update_player(game, game->player);
-    game->frame++;
-    if (test_command_table(game->player->table, COMMAND_PAUSE, REPETITION_DELAY)) {
-      game->paused = 1;
-    }
+void step_game(Game *const game, const InputEvent *const events, const size_t event_count) {
+  size_t i;
+  for (i = 0; i < event_count; i++) {
+    apply_input_event(game->player->table, events + i);
   }
-  if (code != CODE_CLOSE) {
-    register_score(game, renderer);
+  remember_positions(game);
+  if (game->played_frames == game->next_played_frames_score) {
+    player_score_add(game->player, 1);
+    game->next_played_frames_score += get_tick_rate();
   }
-  if (code == CODE_QUIT) {
-    /* When the player quits from the game, it should go back to the menu. */
-    code = CODE_OK;
+  update_game(game);
+  update_player(game, game->player);
+  game->frame++;
+  if (game->engine->logging && is_logging_state_hash() && get_state_hash_period() &&
+      game->frame % get_state_hash_period() == 0) {
+    log_state_hash(game->frame, hash_game_state(game));
   }
-  return code;
 }
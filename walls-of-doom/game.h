@@ -2,25 +2,62 @@
 #define GAME_H
 
 #include "box.h"
+#include "chunked-matrix.h"
 #include "clock.h"
 #include "code.h"
 #include "constants.h"
+#include "engine.h"
 #include "logger.h"
+#include "movement-table.h"
 #include "numeric.h"
+#include "packed-matrix.h"
 #include "perk.h"
+#include "platform-index.h"
+#include "platform-store.h"
 #include "platform.h"
 #include "player.h"
 #include "random.h"
 #include "settings.h"
-#include <SDL.h>
+#include "span-table.h"
+#include "timing-wheel.h"
+#include "worker-pool.h"
 #include <stdlib.h>
 
 typedef struct Game {
 
   Player *player;
 
+  /* The PRNG, the profiler and the logging of this game, so that several games can be simulated at once. */
+  Engine *engine;
+
   Platform *platforms;
   size_t platform_count;
+  /* Which platforms are in each row of tiles. */
+  PlatformIndex *platform_index;
+  /* A structure of arrays copy of the positions and speeds of the platforms, for loops over all of them. */
+  PlatformStore *platform_store;
+
+  /* How many pixels each speed moves in each frame. */
+  MovementTable *movement_table;
+  /* The platforms scheduled by the next frame in which they move. */
+  TimingWheel *platform_wheel;
+  /* The first frame in which each platform may run into another one, before which it moves without collision tests. */
+  unsigned long *collision_frames;
+
+  /* The positions of the platforms and of the player before the last frame, so drawing can blend between frames. */
+  int *previous_x;
+  int *previous_y;
+  int previous_player_x;
+  int previous_player_y;
+
+  /* Only created when platforms are updated by more than one thread. */
+  WorkerPool *worker_pool;
+  /* Scratch space for splitting the platforms due in a frame into groups of rows, allocated along with the pool. */
+  int *row_groups;
+  size_t *group_starts;
+  size_t *group_items;
+  /* The group of the rows the player overlaps or stands on, or -1 if it has no due platforms. */
+  int player_group;
 
   /**
    * In which frame - starting at 0 - we are now.
@@ -32,6 +69,8 @@ typedef struct Game {
    */
   unsigned long played_frames;
   unsigned long limit_played_frames;
+  /* The played frame in which the player gets the next point for surviving. */
+  unsigned long next_played_frames_score;
 
   int paused;
 
@@ -45,10 +84,19 @@ typedef struct Game {
 
   BoundingBox *box;
 
+  CollisionBackend collision_backend;
+
   size_t rigid_matrix_n;
   size_t rigid_matrix_m;
   size_t rigid_matrix_size;
+  /* Only allocated when using the dense collision backend. */
   unsigned char *rigid_matrix;
+  /* Only allocated when using the packed collision backend. */
+  PackedMatrix *packed_matrix;
+  /* Only allocated when using the spans collision backend. */
+  SpanTable *span_table;
+  /* Only allocated when using the chunked collision backend. */
+  ChunkedMatrix *chunked_matrix;
 
   char message[MAXIMUM_STRING_SIZE];
   unsigned long message_end_frame;
@@ -58,16 +106,109 @@ typedef struct Game {
 
 /**
  * Creates a new Game object with the provided objects.
+ *
+ * The engine is used by the game until it is destroyed.
  */
-Game create_game(Player *player);
+Game create_game(Player *player, Engine *engine);
 
 void destroy_game(Game *game);
 
+/**
+ * Rebuilds everything derived from the platforms and from the frame, after they were replaced by a saved state.
+ *
+ * The schedule of platform movements and the collision predictions only depend on the platforms and on the frame, so
+ * the rebuilt game simulates exactly like the game whose state was saved.
+ */
+void rebuild_game(Game *game);
+
 Milliseconds update_game(Game *const game);
 
 unsigned char get_from_rigid_matrix(const Game *const game, const int x, const int y);
-void modify_rigid_matrix_point(const Game *const game, const int x, const int y, const unsigned char delta);
-void modify_rigid_matrix_platform(Game *game, Platform const *platform, const unsigned char delta);
+void modify_rigid_matrix_platform(Game *game, Platform const *platform, const int delta);
+
+/**
+ * Updates the rigid matrix for a horizontal move of the platform by dx.
+ *
+ * Only the columns the platform vacates and the columns it starts to cover are written. The platform itself is not
+ * changed and should still be at its old position.
+ */
+void shift_rigid_matrix_platform(Game *game, Platform const *platform, const int dx);
+
+/**
+ * Evaluates whether or not the rectangle starting at (x, y) is free of rigid bodies.
+ *
+ * Positions outside of the bounding box are always free.
+ */
+int is_rigid_matrix_region_free(const Game *const game, const int x, const int y, const int w, const int h);
+
+/**
+ * Returns how many consecutive columns, starting at column x and advancing in the direction of dx, are free of rigid
+ * bodies in the h rows starting at y.
+ *
+ * At most abs(dx) columns are checked, so this is also the largest value this function returns.
+ */
+int get_rigid_matrix_free_columns(const Game *const game, const int x, const int y, const int h, const int dx);
+
+/**
+ * Returns how many consecutive rows, starting at row y and advancing in the direction of dy, are free of rigid bodies
+ * in the w columns starting at x.
+ *
+ * At most abs(dy) rows are checked, so this is also the largest value this function returns.
+ */
+int get_rigid_matrix_free_rows(const Game *const game, const int x, const int y, const int w, const int dy);
+
+/**
+ * Returns the row of tiles which contains the provided y coordinate, or -1 if it is above the bounding box.
+ */
+int get_platform_row(const Game *const game, const int y);
+
+/**
+ * Updates the platform index after the platform changed rows.
+ */
+void reindex_platform(Game *game, Platform const *platform);
+
+/**
+ * Removes the platform from the platform index until it is reindexed.
+ */
+void unindex_platform(Game *game, Platform const *platform);
+
+/**
+ * Copies the state of the platform to the platform store after it moved. Its speed must not have changed.
+ */
+void mirror_platform(Game *game, Platform const *platform);
+
+/**
+ * Copies the state of the platform to the platform store after its speed changed. This may grow the movement table, so
+ * it must not be called while the platforms are updated.
+ */
+void mirror_platform_speed(Game *game, Platform const *platform);
+
+/**
+ * Remembers the current positions of the platforms and of the player as their positions before the next frame.
+ */
+void remember_positions(Game *game);
+
+/**
+ * Makes the platform appear at its current position until the next frame, instead of moving there from its previous
+ * position. This should be used when the platform was moved elsewhere rather than along its way.
+ */
+void forget_platform_position(Game *game, Platform const *platform);
+
+/**
+ * Makes the player appear at its current position until the next frame, instead of moving there from its previous
+ * position.
+ */
+void forget_player_position(Game *game);
+
+/**
+ * Returns the first platform in the row of tiles, or NULL if there is none.
+ */
+Platform *get_first_platform_in_row(const Game *const game, const int row);
+
+/**
+ * Returns the platform after the provided one in its row of tiles, or NULL if it is the last one.
+ */
+Platform *get_next_platform_in_row(const Game *const game, Platform const *platform);
 
 /**
  * Changes the game message to the provided text, for the provided duration.
@@ -79,8 +220,16 @@ void modify_rigid_matrix_platform(Game *game, Platform const *platform, const un
 void game_set_message(Game *const game, const char *message, const unsigned long duration, const unsigned int priority);
 
 /**
- * Runs the main game loop for the Game object and registers the player score.
+ * Evaluates whether or not the game should go on: the player did not quit, has lives left and did not reach the limit
+ * of played frames.
+ */
+int is_game_running(const Game *const game);
+
+/**
+ * Applies the input events to the command table of the player, in order, and simulates a single frame.
+ *
+ * This does not depend on any clock, so the game can be simulated as fast as the processor allows.
  */
-Code run_game(Game *const game, SDL_Renderer *renderer);
+void step_game(Game *const game, const InputEvent *const events, const size_t event_count);
 
 #endif
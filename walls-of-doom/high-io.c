@@ -2,6 +2,7 @@
 #include "base-io.h"
 #include "clock.h"
 #include "constants.h"
+#include "fixed.h"
 #include "game.h"
 #include "joystick.h"
 #include "logger.h"
@@ -23,7 +24,7 @@
 
 #define GAME_NAME "Walls of Doom"
 
-#define PERK_FADING_INTERVAL FPS
+#define PERK_FADING_INTERVAL get_tick_rate()
 
 /**
  * Evaluates whether or not a Player name is a valid name.
@@ -54,7 +55,7 @@ Code read_player_name(char *destination, const size_t maximum_size, Renderer *re
   /* While there is not a read error or a valid name. */
   while (code != CODE_OK || !valid_name) {
     x = get_padding() * get_font_width();
-    y = (get_window_height() - get_font_height()) / 2;
+    y = (get_logical_height() - get_font_height()) / 2;
     code = read_string(x, y, message, destination, maximum_size, renderer);
     if (code == CODE_QUIT) {
       return CODE_QUIT;
@@ -131,7 +132,7 @@ static void write_top_bar_strings(char *strings[], Renderer *renderer) {
   const int string_count = TOP_BAR_STRING_COUNT;
   const int y = (get_bar_height() - get_font_height()) / 2;
   int h = get_bar_height();
-  int w = get_window_width();
+  int w = get_logical_width();
   draw_absolute_rectangle(0, 0, w, h, color_pair.background, renderer);
   print_centered_horizontally(y, string_count, strings, color_pair, renderer);
 }
@@ -147,7 +148,7 @@ static void draw_top_bar(const Game *game, Renderer *renderer) {
   char *strings[TOP_BAR_STRING_COUNT];
   char *perk_name = "No Power";
   const unsigned long limit = game->limit_played_frames;
-  double time_left = (limit - game->played_frames) / (double)FPS;
+  double time_left = (limit - game->played_frames) / (double)get_tick_rate();
   sprintf(time_buffer, "%.2f s", time_left);
   if (player->perk != PERK_NONE) {
     perk_name = get_perk_name(player->perk);
@@ -164,7 +165,7 @@ static void draw_top_bar(const Game *game, Renderer *renderer) {
 static void write_bottom_bar_string(const char *string, Renderer *renderer) {
   /* Use half a character for horizontal padding. */
   const int x = get_font_width() / 2;
-  const int bar_start = get_window_height() - get_bar_height();
+  const int bar_start = get_logical_height() - get_bar_height();
   const int padding = (get_bar_height() - get_font_height()) / 2;
   const int y = bar_start + padding;
   print_absolute(x, y, string, COLOR_PAIR_BOTTOM_BAR, renderer);
@@ -175,16 +176,23 @@ static void write_bottom_bar_string(const char *string, Renderer *renderer) {
  */
 static void draw_bottom_bar(const char *message, Renderer *renderer) {
   const Color color = COLOR_PAIR_BOTTOM_BAR.background;
-  const int y = get_window_height() - get_bar_height();
-  const int w = get_window_width();
+  const int y = get_logical_height() - get_bar_height();
+  const int w = get_logical_width();
   const int h = get_bar_height();
   draw_absolute_rectangle(0, y, w, h, color, renderer);
   write_bottom_bar_string(message, renderer);
 }
 
-static void draw_platforms(const Platform *platforms, const size_t platform_count, const BoundingBox *box,
-                           Renderer *renderer) {
+/**
+ * Returns the position blend / FIXED_ONE of the way from the previous position to the current one.
+ */
+static int interpolate(const int previous, const int current, const Fixed blend) {
+  return previous + (int)floor_divide((long)(current - previous) * blend, FIXED_ONE);
+}
+
+static void draw_platforms(const Game *const game, const Fixed blend, Renderer *renderer) {
   const Color color = COLOR_PAIR_PLATFORM.foreground;
+  const BoundingBox *box = game->box;
   const int y_padding = get_bar_height();
   Platform p;
   int x;
@@ -192,8 +200,10 @@ static void draw_platforms(const Platform *platforms, const size_t platform_coun
   int w;
   int h;
   size_t i;
-  for (i = 0; i < platform_count; i++) {
-    p = platforms[i];
+  for (i = 0; i < game->platform_count; i++) {
+    p = game->platforms[i];
+    p.x = interpolate(game->previous_x[i], p.x, blend);
+    p.y = interpolate(game->previous_y[i], p.y, blend);
     x = max_int(box->min_x, p.x);
     y = y_padding + p.y;
     w = min_int(box->max_x, p.x + p.w - 1) - x + 1;
@@ -254,9 +264,10 @@ static void draw_perk(const Game *const game, Renderer *renderer) {
   }
 }
 
-Code draw_player(const Player *const player, Renderer *renderer) {
-  int x = player->x;
-  int y = player->y;
+static Code draw_player(const Game *const game, const Fixed blend, Renderer *renderer) {
+  const Player *const player = game->player;
+  int x = interpolate(game->previous_player_x, player->x, blend);
+  int y = interpolate(game->previous_player_y, player->y, blend);
   size_t i;
   const size_t head = player->graphics->trail_head;
   const size_t size = player->graphics->trail_size;
@@ -275,40 +286,43 @@ Code draw_player(const Player *const player, Renderer *renderer) {
 /**
  * Draws a full game to the screen.
  *
+ * The platforms and the player are drawn blend / FIXED_ONE of the way from their positions before the last frame to
+ * their current positions, so that drawing between frames shows smooth movement.
+ *
  * Returns a Milliseconds approximation of the time this function took.
  */
-Milliseconds draw_game(const Game *const game, Renderer *renderer) {
+Milliseconds draw_game(const Game *const game, const Fixed blend, Renderer *renderer) {
   Milliseconds draw_game_start = get_milliseconds();
 
-  profiler_begin("draw_game:clear");
+  profiler_begin(game->engine->profiler, "draw_game:clear");
   clear(renderer);
-  profiler_end("draw_game:clear");
+  profiler_end(game->engine->profiler, "draw_game:clear");
 
-  profiler_begin("draw_game:draw_top_bar");
+  profiler_begin(game->engine->profiler, "draw_game:draw_top_bar");
   draw_top_bar(game, renderer);
-  profiler_end("draw_game:draw_top_bar");
+  profiler_end(game->engine->profiler, "draw_game:draw_top_bar");
 
-  profiler_begin("draw_game:draw_bottom_bar");
+  profiler_begin(game->engine->profiler, "draw_game:draw_bottom_bar");
   draw_bottom_bar(game->message, renderer);
-  profiler_end("draw_game:draw_bottom_bar");
+  profiler_end(game->engine->profiler, "draw_game:draw_bottom_bar");
 
-  profiler_begin("draw_game:draw_platforms");
-  draw_platforms(game->platforms, game->platform_count, game->box, renderer);
-  profiler_end("draw_game:draw_platforms");
+  profiler_begin(game->engine->profiler, "draw_game:draw_platforms");
+  draw_platforms(game, blend, renderer);
+  profiler_end(game->engine->profiler, "draw_game:draw_platforms");
 
-  profiler_begin("draw_game:draw_perk");
+  profiler_begin(game->engine->profiler, "draw_game:draw_perk");
   draw_perk(game, renderer);
-  profiler_end("draw_game:draw_perk");
+  profiler_end(game->engine->profiler, "draw_game:draw_perk");
 
-  profiler_begin("draw_game:draw_player");
-  draw_player(game->player, renderer);
-  profiler_end("draw_game:draw_player");
+  profiler_begin(game->engine->profiler, "draw_game:draw_player");
+  draw_player(game, blend, renderer);
+  profiler_end(game->engine->profiler, "draw_game:draw_player");
 
-  profiler_begin("draw_game:present");
+  profiler_begin(game->engine->profiler, "draw_game:present");
   present(renderer);
-  profiler_end("draw_game:present");
+  profiler_end(game->engine->profiler, "draw_game:present");
 
-  update_profiler("draw_game", get_milliseconds() - draw_game_start);
+  update_profiler(game->engine->profiler, "draw_game", get_milliseconds() - draw_game_start);
   return get_milliseconds() - draw_game_start;
 }
 
@@ -331,9 +345,9 @@ void print_records(const size_t count, const Record *records, Renderer *renderer
   const ColorPair pair = COLOR_PAIR_DEFAULT;
   const int x_padding = 2 * get_padding() * get_font_width();
   const int y_padding = 2 * get_padding() * get_font_height();
-  const int available_window_height = get_window_height() - y_padding;
+  const int available_window_height = get_logical_height() - y_padding;
   const int text_lines_limit = available_window_height / get_font_height();
-  const int text_width_in_pixels = get_window_width() - x_padding;
+  const int text_width_in_pixels = get_logical_width() - x_padding;
   const size_t string_width = text_width_in_pixels / get_font_width();
   const size_t printed = min_int(count, text_lines_limit);
   char **strings = NULL;
@@ -400,7 +414,7 @@ Code read_string(const int x, const int y, const char *prompt, char *destination
                  Renderer *renderer) {
   const int buffer_x = x + (strlen(prompt) + 1) * get_font_width();
   const int padding_size = get_padding() * get_font_width();
-  const int buffer_view_size = get_window_width() - buffer_x - padding_size;
+  const int buffer_view_size = get_logical_width() - buffer_x - padding_size;
   const int buffer_view_limit = buffer_view_size / get_font_width();
   int is_done = 0;
   int should_rerender = 1;
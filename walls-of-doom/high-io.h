@@ -6,6 +6,7 @@
 #include "code.h"
 #include "color.h"
 #include "command.h"
+#include "fixed.h"
 #include "game.h"
 #include "perk.h"
 #include "physics.h"
@@ -28,9 +29,12 @@ Code read_player_name(char *destination, const size_t maximum_size, Renderer *re
 /**
  * Draws a full game to the screen.
  *
+ * The platforms and the player are drawn blend / FIXED_ONE of the way from their positions before the last frame to
+ * their current positions, so that drawing between frames shows smooth movement.
+ *
  * Returns a Milliseconds approximation of the time this function took.
  */
-Milliseconds draw_game(const Game *const game, Renderer *renderer);
+Milliseconds draw_game(const Game *const game, const Fixed blend, Renderer *renderer);
 
 /**
  * Prints the provided string on the screen starting at (x, y).
@@ -0,0 +1,85 @@
+#include "input-queue.h"
+#include "input.h"
+#include <string.h>
+
+void initialize_input_queue(InputQueue *queue) {
+  queue->first = 0;
+  queue->count = 0;
+}
+
+static InputEvent *get_event(InputQueue *queue, const size_t index) {
+  return queue->events + (queue->first + index) % INPUT_QUEUE_CAPACITY;
+}
+
+static void pop_event(InputQueue *queue) {
+  queue->first = (queue->first + 1) % INPUT_QUEUE_CAPACITY;
+  queue->count--;
+}
+
+/**
+ * Adds an event to the end of the queue, returning 0 if the queue is full.
+ *
+ * Joystick axis motion is coalesced: if the last event in the queue is motion of the same axis, it is replaced, as only
+ * the latest position of an axis matters to a frame.
+ */
+int input_queue_push(InputQueue *queue, const InputEvent event) {
+  InputEvent *last;
+  if (queue->count > 0) {
+    last = get_event(queue, queue->count - 1);
+    if (event.axis && last->axis && last->command == event.command) {
+      *last = event;
+      return 1;
+    }
+  }
+  if (queue->count == INPUT_QUEUE_CAPACITY) {
+    return 0;
+  }
+  *get_event(queue, queue->count) = event;
+  queue->count++;
+  return 1;
+}
+
+/**
+ * Moves all pending SDL events to the queue.
+ *
+ * If the queue fills up, its oldest events are applied to the table right away to make room, so no input is lost.
+ */
+void read_input_queue(InputQueue *queue, CommandTable *table) {
+  InputEvent event;
+  while (poll_input_event(&event)) {
+    if (event.command == COMMAND_NONE) {
+      continue;
+    }
+    if (!input_queue_push(queue, event)) {
+      apply_input_event(table, get_event(queue, 0));
+      pop_event(queue);
+      input_queue_push(queue, event);
+    }
+  }
+}
+
+/**
+ * Applies the events made up to the provided time to the table, in order.
+ *
+ * A release of a command pressed by an earlier event applied by the same call is left in the queue, together with all
+ * events after it, so that the frame sees the command pressed even if the press and the release happened within it.
+ */
+void apply_input_queue(InputQueue *queue, CommandTable *table, const Milliseconds time) {
+  int pressed[COMMAND_COUNT];
+  InputEvent *event;
+  memset(pressed, 0, sizeof(pressed));
+  while (queue->count > 0) {
+    event = get_event(queue, 0);
+    if (event->time > time) {
+      return;
+    }
+    if (!event->axis) {
+      if (event->value == 0.0 && pressed[event->command]) {
+        return;
+      }
+      pressed[event->command] = event->value != 0.0;
+    }
+    apply_input_event(table, event);
+    pop_event(queue);
+  }
+}
@@ -0,0 +1,49 @@
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include "clock.h"
+#include "command.h"
+#include <stdlib.h>
+
+#define INPUT_QUEUE_CAPACITY 256
+
+/**
+ * A ring buffer of input events waiting for the simulation to reach the time they were made at.
+ *
+ * Reading commands once per iteration applies all input at once, so a key pressed and released between two frames is
+ * never seen by the game, and all input is effectively delayed to the start of the iteration. The queue instead keeps
+ * the timestamp SDL gives each event, so that every simulated frame applies exactly the events made up to its end, in
+ * the order they were made.
+ */
+typedef struct InputQueue {
+  InputEvent events[INPUT_QUEUE_CAPACITY];
+  size_t first;
+  size_t count;
+} InputQueue;
+
+void initialize_input_queue(InputQueue *queue);
+
+/**
+ * Adds an event to the end of the queue, returning 0 if the queue is full.
+ *
+ * Joystick axis motion is coalesced: if the last event in the queue is motion of the same axis, it is replaced, as only
+ * the latest position of an axis matters to a frame.
+ */
+int input_queue_push(InputQueue *queue, const InputEvent event);
+
+/**
+ * Moves all pending SDL events to the queue.
+ *
+ * If the queue fills up, its oldest events are applied to the table right away to make room, so no input is lost.
+ */
+void read_input_queue(InputQueue *queue, CommandTable *table);
+
+/**
+ * Applies the events made up to the provided time to the table, in order.
+ *
+ * A release of a command pressed by an earlier event applied by the same call is left in the queue, together with all
+ * events after it, so that the frame sees the command pressed even if the press and the release happened within it.
+ */
+void apply_input_queue(InputQueue *queue, CommandTable *table, const Milliseconds time);
+
+#endif
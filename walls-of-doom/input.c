@@ -0,0 +1,134 @@
+#include "input.h"
+#include "clock.h"
+#include "joystick.h"
+#include <SDL.h>
+#include <stdlib.h>
+
+/**
+ * Returns the Command value corresponding to the provided key combination.
+ */
+static Command command_from_key(const SDL_Keysym keysym) {
+  const SDL_Keycode sym = keysym.sym;
+  const Uint16 mod = keysym.mod;
+  if (sym == SDLK_KP_8 || sym == SDLK_UP) {
+    return COMMAND_UP;
+  }
+  if (sym == SDLK_KP_4 || sym == SDLK_LEFT) {
+    return COMMAND_LEFT;
+  } else if (sym == SDLK_KP_5) {
+    return COMMAND_CENTER;
+  } else if (sym == SDLK_KP_6 || sym == SDLK_RIGHT) {
+    return COMMAND_RIGHT;
+  } else if (sym == SDLK_KP_2 || sym == SDLK_DOWN) {
+    return COMMAND_DOWN;
+  } else if (sym == SDLK_SPACE) {
+    return COMMAND_JUMP;
+  } else if (sym == SDLK_RETURN || sym == SDLK_KP_ENTER) {
+    return COMMAND_ENTER;
+  } else if (sym == SDLK_c) {
+    return COMMAND_CONVERT;
+  } else if (sym == SDLK_i) {
+    if (mod & KMOD_SHIFT) {
+      return COMMAND_INVEST_ALL;
+    }
+    return COMMAND_INVEST;
+  } else if (sym == SDLK_p) {
+    return COMMAND_PAUSE;
+  } else if (sym == SDLK_q) {
+    return COMMAND_QUIT;
+  }
+  return COMMAND_NONE;
+}
+
+/**
+ * Returns the command of the positive direction of a joystick axis.
+ */
+static Command command_from_axis(const Uint8 axis) { return axis == 0 ? COMMAND_RIGHT : COMMAND_DOWN; }
+
+static void make_input_event(InputEvent *input, const Command command, const double value, const int axis) {
+  input->command = command;
+  input->value = value;
+  input->axis = axis;
+}
+
+static void digest_joystick_event(InputEvent *input, const SDL_Event event) {
+  double value;
+  if (event.type == SDL_JOYBUTTONDOWN) {
+    make_input_event(input, command_from_joystick_event(event), 1.0, 0);
+  } else if (event.type == SDL_JOYBUTTONUP) {
+    make_input_event(input, command_from_joystick_event(event), 0.0, 0);
+  } else if (abs(event.jaxis.value) > JOYSTICK_DEAD_ZONE) {
+    value = event.jaxis.value / (double)MAXIMUM_JOYSTICK_AXIS_VALUE;
+    make_input_event(input, command_from_axis(event.jaxis.axis), value, 1);
+  } else {
+    make_input_event(input, command_from_axis(event.jaxis.axis), 0.0, 1);
+  }
+}
+
+static void digest_event(InputEvent *input, const SDL_Event event) {
+  const Uint32 ticks = SDL_GetTicks();
+  /* SDL stamps events with its own clock, so convert how long ago the event happened to the clock of the game. */
+  const Uint32 age = ticks > event.common.timestamp ? ticks - event.common.timestamp : 0;
+  input->time = get_milliseconds() - age;
+  if (event.type == SDL_QUIT) {
+    make_input_event(input, COMMAND_QUIT, 1.0, 0);
+  } else if (event.type == SDL_KEYDOWN) {
+    make_input_event(input, command_from_key(event.key.keysym), 1.0, 0);
+  } else if (event.type == SDL_KEYUP) {
+    make_input_event(input, command_from_key(event.key.keysym), 0.0, 0);
+  } else if (event.type == SDL_JOYAXISMOTION || event.type == SDL_JOYBUTTONDOWN || event.type == SDL_JOYBUTTONUP) {
+    digest_joystick_event(input, event);
+  } else {
+    make_input_event(input, COMMAND_NONE, 0.0, 0);
+  }
+}
+
+void read_commands(CommandTable *table) {
+  InputEvent input;
+  while (poll_input_event(&input)) {
+    apply_input_event(table, &input);
+  }
+}
+
+/**
+ * Takes the next input event from SDL, returning 0 if there are no more events.
+ *
+ * Events which do not map to any command are returned as COMMAND_NONE events.
+ */
+int poll_input_event(InputEvent *input) {
+  SDL_Event event;
+  if (!SDL_PollEvent(&event)) {
+    return 0;
+  }
+  digest_event(input, event);
+  return 1;
+}
+
+/**
+ * Waits for any user input, blocking indefinitely.
+ */
+Code wait_for_input(CommandTable *table) {
+  SDL_Event event;
+  InputEvent input;
+  while (1) {
+    if (SDL_WaitEvent(&event)) {
+      digest_event(&input, event);
+      apply_input_event(table, &input);
+      if (event.type == SDL_QUIT) {
+        return CODE_QUIT;
+      }
+      /* Mark this command as read. This prevents a key press from being carried to another screen. */
+      if (event.type == SDL_KEYDOWN) {
+        test_command_table(table, command_from_key(event.key.keysym), 0);
+        return CODE_OK;
+      }
+      if (event.type == SDL_JOYBUTTONDOWN) {
+        test_command_table(table, command_from_joystick_event(event), 0);
+        return CODE_OK;
+      }
+    } else {
+      /* WaitEvent returns 0 to indicate errors. */
+      return CODE_ERROR;
+    }
+  }
+}
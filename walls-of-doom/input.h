@@ -0,0 +1,24 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include "code.h"
+#include "command.h"
+
+/**
+ * Applies all pending SDL events to the table.
+ */
+void read_commands(CommandTable *table);
+
+/**
+ * Takes the next input event from SDL, returning 0 if there are no more events.
+ *
+ * Events which do not map to any command are returned as COMMAND_NONE events.
+ */
+int poll_input_event(InputEvent *event);
+
+/**
+ * Waits for any user input, blocking indefinitely.
+ */
+Code wait_for_input(CommandTable *table);
+
+#endif
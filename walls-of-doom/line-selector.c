@@ -0,0 +1,138 @@
+#include "line-selector.h"
+#include "memory.h"
+#include "random.h"
+
+LineSelector *create_line_selector(const int size) {
+  LineSelector *selector = resize_memory(NULL, sizeof(LineSelector));
+  int i;
+  selector->size = size;
+  selector->runs = resize_memory(NULL, sizeof(int) * (size > 0 ? size : 1));
+  selector->tree = resize_memory(NULL, sizeof(int) * (size > 0 ? size + 1 : 1));
+  for (i = 0; i < size; i++) {
+    selector->runs[i] = 0;
+  }
+  if (size > 0) {
+    selector->runs[0] = size;
+  }
+  /* Any positive distance makes the first selection build the tree. */
+  selector->distance = 1;
+  selector->count = 0;
+  return selector;
+}
+
+LineSelector *destroy_line_selector(LineSelector *selector) {
+  if (selector != NULL) {
+    selector->runs = resize_memory(selector->runs, 0);
+    selector->tree = resize_memory(selector->tree, 0);
+  }
+  return resize_memory(selector, 0);
+}
+
+/**
+ * Returns the distance to the closest occupied line of the furthest lines of a run.
+ */
+static int get_run_distance(const int run) { return (run + 1) / 2; }
+
+/**
+ * Returns how many lines of a run are at its distance: one line if its length is odd, two lines otherwise.
+ */
+static int get_run_ties(const int run) { return run % 2 ? 1 : 2; }
+
+static void add_to_tree(LineSelector *selector, const int start, const int delta) {
+  int i;
+  for (i = start + 1; i <= selector->size; i += i & -i) {
+    selector->tree[i] += delta;
+  }
+  selector->count += delta;
+}
+
+/**
+ * Returns the start of the run which offers the line with the provided rank, and makes the rank relative to the run.
+ */
+static int find_in_tree(const LineSelector *const selector, int *rank) {
+  int step = 1;
+  int position = 0;
+  while (2 * step <= selector->size) {
+    step *= 2;
+  }
+  for (; step > 0; step /= 2) {
+    if (position + step <= selector->size && selector->tree[position + step] <= *rank) {
+      position += step;
+      *rank -= selector->tree[position];
+    }
+  }
+  return position;
+}
+
+/**
+ * Records a new run of empty lines, offering its lines if they are at the current distance.
+ */
+static void add_run(LineSelector *selector, const int start, const int run) {
+  if (run > 0) {
+    selector->runs[start] = run;
+    if (get_run_distance(run) == selector->distance) {
+      add_to_tree(selector, start, get_run_ties(run));
+    }
+  }
+}
+
+/**
+ * Rebuilds the tree for the longest runs left.
+ *
+ * Splitting a run never creates a longer run, so the distance only decreases.
+ */
+static void rebuild_tree(LineSelector *selector) {
+  int i;
+  selector->distance = 0;
+  selector->count = 0;
+  for (i = 0; i < selector->size; i++) {
+    if (get_run_distance(selector->runs[i]) > selector->distance) {
+      selector->distance = get_run_distance(selector->runs[i]);
+    }
+  }
+  for (i = 0; i <= selector->size; i++) {
+    selector->tree[i] = 0;
+  }
+  for (i = 0; i < selector->size; i++) {
+    if (selector->runs[i] > 0 && get_run_distance(selector->runs[i]) == selector->distance) {
+      add_to_tree(selector, i, get_run_ties(selector->runs[i]));
+    }
+  }
+}
+
+/**
+ * Selects at random one of the lines which are the furthest away from any occupied line and marks it as occupied.
+ *
+ * If all lines are occupied, any line may be selected.
+ */
+int line_selector_select(LineSelector *selector, RandomState *random) {
+  int start;
+  int run;
+  int rank;
+  int line;
+  /* Be careful not to call random_state_integer with invalid parameters. */
+  if (selector->size < 1) {
+    return 0;
+  }
+  if (selector->count == 0 && selector->distance > 0) {
+    rebuild_tree(selector);
+  }
+  /* No empty lines, so all lines are at distance zero. */
+  if (selector->distance == 0) {
+    return random_state_integer(random, 0, selector->size - 1);
+  }
+  rank = random_state_integer(random, 0, selector->count - 1);
+  start = find_in_tree(selector, &rank);
+  run = selector->runs[start];
+  /* The first line offered by a run is the one closer to its start. */
+  if (rank == 0) {
+    line = start - 1 + selector->distance;
+  } else {
+    line = start + run - selector->distance;
+  }
+  add_to_tree(selector, start, -get_run_ties(run));
+  selector->runs[start] = 0;
+  add_run(selector, start, line - start);
+  add_run(selector, line + 1, start + run - line - 1);
+  return line;
+}
@@ -0,0 +1,44 @@
+#ifndef LINE_SELECTOR_H
+#define LINE_SELECTOR_H
+
+#include "random.h"
+#include <stdlib.h>
+
+/**
+ * Selects lines which are the furthest away from any occupied line while lines are occupied one after the other.
+ *
+ * Repeatedly selecting a line with select_random_line_awarely and marking it as occupied rescans all lines on every
+ * selection. The selector instead keeps the runs of empty lines between occupied lines, and a Fenwick tree of how many
+ * lines each run offers at the current maximum distance, so that a selection only splits one run. The tree is rebuilt
+ * when no run offers lines at the current distance anymore, which happens about log2(size) times.
+ *
+ * Selections consume random numbers exactly like select_random_line_awarely does, so both produce the same lines.
+ */
+
+typedef struct LineSelector {
+  int size;
+  /* The length of the run of empty lines starting at each line, or 0 if no run starts there. */
+  int *runs;
+  /* A Fenwick tree of the lines offered by the run starting at each line, indexed from 1. */
+  int *tree;
+  /* The distance of the lines offered by the tree, or 0 after all lines are occupied. */
+  int distance;
+  /* How many lines the tree offers. */
+  int count;
+} LineSelector;
+
+/**
+ * Creates a new LineSelector with all lines empty.
+ */
+LineSelector *create_line_selector(const int size);
+
+LineSelector *destroy_line_selector(LineSelector *selector);
+
+/**
+ * Selects at random one of the lines which are the furthest away from any occupied line and marks it as occupied.
+ *
+ * If all lines are occupied, any line may be selected.
+ */
+int line_selector_select(LineSelector *selector, RandomState *random);
+
+#endif
@@ -17,6 +17,8 @@
 
 #define SCORE_FILE_NAME "score.txt"
 
+#define STATE_HASH_FILE_NAME "hash.txt"
+
 #define LOG_MESSAGE_SIZE (TIMESTAMP_BUFFER_SIZE + 256)
 
 /**
@@ -89,3 +91,13 @@ void log_player_score(const unsigned long frame, const Score score) {
     append_to_file(path, string);
   }
 }
+
+void log_state_hash(const unsigned long frame, const unsigned long hash) {
+  char path[MAXIMUM_PATH_SIZE];
+  char string[LOG_MESSAGE_SIZE];
+  if (is_logging_state_hash()) {
+    get_full_path(path, STATE_HASH_FILE_NAME);
+    sprintf(string, "%lu,%08lx", frame, hash);
+    append_to_file(path, string);
+  }
+}
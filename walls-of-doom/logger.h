@@ -20,4 +20,6 @@ void log_message(const char *message);
 
 void log_player_score(const unsigned long frame, const Score score);
 
+void log_state_hash(const unsigned long frame, const unsigned long hash);
+
 #endif
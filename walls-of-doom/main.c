@@ -1,8 +1,11 @@
+#include "game-loop.h"
 #include "high-io.h"
 #include "logger.h"
 #include "memory.h"
 #include "menu.h"
 #include "random.h"
+#include "replay.h"
+#include "settings.h"
 #include "text.h"
 #include "version.h"
 #include <SDL.h>
@@ -30,16 +33,76 @@ ParserResult parse_argument(const char *argument) {
   return PARSER_RESULT_QUIT;
 }
 
+/**
+ * Plays the replay in the file instead of the menu, returning a nonzero value if the file is not a valid replay.
+ */
+int play_replay(const char *filename, const int unlimited, SDL_Renderer *renderer) {
+  char name[MAXIMUM_PLAYER_NAME_SIZE] = "Replay";
+  ReplayReader *replay;
+  CommandTable table;
+  Player player;
+  Engine engine;
+  Game game;
+  initialize_engine(&engine, create_random_state(0));
+  engine.profiler = get_main_profiler();
+  replay = create_replay_reader(filename, &engine);
+  if (replay == NULL) {
+    return 1;
+  }
+  /* The replay may have been recorded with another logical size. */
+  if (is_logical_size_scaled()) {
+    SDL_RenderSetLogicalSize(renderer, get_logical_width(), get_logical_height());
+  }
+  initialize_command_table(&table);
+  player = create_player(name, &table);
+  game = create_game(&player, &engine);
+  run_replay(&game, replay, unlimited, renderer);
+  destroy_game(&game);
+  destroy_replay_reader(replay);
+  return 0;
+}
+
+/**
+ * Simulates the replay in the file and prints whether it played exactly like it was recorded.
+ *
+ * Returns a nonzero value if it did not or if this could not be verified.
+ */
+int print_replay_verification(const char *filename) {
+  unsigned long frame = 0;
+  ReplayVerdict verdict;
+  /* The local settings choose how the game is simulated, such as the collision backend, which should not matter. */
+  initialize_settings();
+  verdict = verify_replay(filename, &frame);
+  if (verdict == REPLAY_IDENTICAL) {
+    printf("The replay played identically for %lu frames.\n", frame);
+  } else if (verdict == REPLAY_DIVERGED) {
+    printf("The replay diverged at frame %lu.\n", frame);
+  } else if (verdict == REPLAY_WITHOUT_HASHES) {
+    printf("The replay has no state hashes to verify.\n");
+  } else {
+    printf("Could not read the replay.\n");
+  }
+  return verdict != REPLAY_IDENTICAL;
+}
+
 /* Must be declared with parameters because of SDL 2. */
 int main(int argc, char *argv[]) {
   int i;
   int quit = 0;
   int result = 0;
+  int unlimited = 0;
+  const char *replay = NULL;
+  const char *verification = NULL;
   SDL_Window *window;
   SDL_Renderer *renderer;
   if (argc > 1) {
     for (i = 1; i < argc && !quit; i++) {
-      if (parse_argument(argv[i]) == PARSER_RESULT_QUIT) {
+      if ((string_equals(argv[i], "--replay") || string_equals(argv[i], "--replay-unlimited")) && i + 1 < argc) {
+        unlimited = string_equals(argv[i], "--replay-unlimited");
+        replay = argv[++i];
+      } else if (string_equals(argv[i], "--verify-replay") && i + 1 < argc) {
+        verification = argv[++i];
+      } else if (parse_argument(argv[i]) == PARSER_RESULT_QUIT) {
         quit = 1;
       }
     }
@@ -47,9 +110,16 @@ int main(int argc, char *argv[]) {
   if (quit) {
     return result;
   }
+  if (verification != NULL) {
+    return print_replay_verification(verification);
+  }
   seed_random();
   initialize(&window, &renderer);
-  result = main_menu(renderer);
+  if (replay != NULL) {
+    result = play_replay(replay, unlimited, renderer);
+  } else {
+    result = main_menu(renderer);
+  }
   finalize(&window, &renderer);
   return result;
 }
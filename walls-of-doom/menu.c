@@ -2,14 +2,17 @@
 #include "about.h"
 #include "constants.h"
 #include "data.h"
+#include "game-loop.h"
 #include "game.h"
 #include "high-io.h"
+#include "input.h"
 #include "logger.h"
 #include "memory.h"
 #include "physics.h"
 #include "platform.h"
 #include "random.h"
 #include "record.h"
+#include "replay.h"
 #include "settings.h"
 #include "text.h"
 #include "version.h"
@@ -70,7 +73,10 @@ void write_menu(const Menu *const menu, SDL_Renderer *renderer) {
 
 Code game(SDL_Renderer *renderer, CommandTable *table) {
   char name[MAXIMUM_PLAYER_NAME_SIZE];
+  char path[MAXIMUM_PATH_SIZE];
+  ReplayWriter *replay;
   Player player;
+  Engine engine;
   Game game;
   Code code;
   code = read_player_name(name, MAXIMUM_PLAYER_NAME_SIZE, renderer);
@@ -78,9 +84,16 @@ Code game(SDL_Renderer *renderer, CommandTable *table) {
     return code;
   }
   player = create_player(name, table);
-  game = create_game(&player);
-  code = run_game(&game, renderer);
+  initialize_engine(&engine, derive_random_state());
+  engine.profiler = get_main_profiler();
+  engine.logging = 1;
+  get_full_path(path, REPLAY_FILE);
+  /* Created right before the game, so that it saves the PRNG state the game is created from. */
+  replay = create_replay_writer(path, &engine);
+  game = create_game(&player, &engine);
+  code = run_game(&game, replay, renderer);
   destroy_game(&game);
+  destroy_replay_writer(replay);
   return code;
 }
 
@@ -0,0 +1,139 @@
+#include "movement-table.h"
+#include "memory.h"
+
+#define INITIAL_SLOT_COUNT 64
+#define EMPTY_SLOT -1
+
+static void clear_slots(long *slots, const size_t slot_count) {
+  size_t i;
+  for (i = 0; i < slot_count; i++) {
+    slots[i] = EMPTY_SLOT;
+  }
+}
+
+MovementTable *create_movement_table(const int frames_per_second) {
+  MovementTable *table = resize_memory(NULL, sizeof(MovementTable));
+  table->frames_per_second = frames_per_second;
+  table->row_count = 0;
+  table->row_capacity = 0;
+  table->speeds = NULL;
+  table->movements = NULL;
+  table->waits = NULL;
+  table->slot_count = INITIAL_SLOT_COUNT;
+  table->slots = resize_memory(NULL, sizeof(long) * table->slot_count);
+  clear_slots(table->slots, table->slot_count);
+  return table;
+}
+
+MovementTable *destroy_movement_table(MovementTable *table) {
+  if (table != NULL) {
+    table->speeds = resize_memory(table->speeds, 0);
+    table->movements = resize_memory(table->movements, 0);
+    table->waits = resize_memory(table->waits, 0);
+    table->slots = resize_memory(table->slots, 0);
+  }
+  return resize_memory(table, 0);
+}
+
+static size_t hash_speed(const int speed, const size_t slot_count) {
+  /* Multiplicative hashing, as speeds are often close to each other. */
+  return ((unsigned long)speed * 2654435761UL) & (slot_count - 1);
+}
+
+/**
+ * Returns the slot of the speed, or the empty slot where it should be inserted.
+ */
+static size_t find_slot(const MovementTable *const table, const int speed) {
+  size_t slot = hash_speed(speed, table->slot_count);
+  while (table->slots[slot] != EMPTY_SLOT && table->speeds[table->slots[slot]] != speed) {
+    slot = (slot + 1) & (table->slot_count - 1);
+  }
+  return slot;
+}
+
+static void grow_slots(MovementTable *table) {
+  size_t row;
+  table->slot_count *= 2;
+  table->slots = resize_memory(table->slots, sizeof(long) * table->slot_count);
+  clear_slots(table->slots, table->slot_count);
+  for (row = 0; row < table->row_count; row++) {
+    table->slots[find_slot(table, table->speeds[row])] = row;
+  }
+}
+
+static void fill_row(int *movements, const int speed, const unsigned long fps) {
+  unsigned long moved = 0;
+  unsigned long frame;
+  unsigned long total;
+  /* Frames are counted from fps so that the first frame of a second also has a previous frame. */
+  moved = (fps - 1) * speed / fps;
+  for (frame = fps; frame < 2 * fps; frame++) {
+    total = frame * speed / fps;
+    movements[frame - fps] = total - moved;
+    moved = total;
+  }
+}
+
+static void fill_waits(const int *movements, int *waits, const int fps) {
+  int next = -1;
+  int frame;
+  /* Walk backwards twice around the second, so that every frame sees the next frame with movement after it. */
+  for (frame = 2 * fps - 1; frame >= 0; frame--) {
+    if (frame < fps) {
+      waits[frame] = next < 0 ? 0 : next - frame;
+    }
+    if (movements[frame % fps]) {
+      next = frame;
+    }
+  }
+}
+
+static size_t add_row(MovementTable *table, const int speed) {
+  const int fps = table->frames_per_second;
+  const size_t row = table->row_count;
+  if (row == table->row_capacity) {
+    table->row_capacity = table->row_capacity ? 2 * table->row_capacity : 16;
+    table->speeds = resize_memory(table->speeds, sizeof(int) * table->row_capacity);
+    table->movements = resize_memory(table->movements, sizeof(int) * fps * table->row_capacity);
+    table->waits = resize_memory(table->waits, sizeof(int) * fps * table->row_capacity);
+  }
+  table->speeds[row] = speed;
+  fill_row(table->movements + row * fps, speed, fps);
+  fill_waits(table->movements + row * fps, table->waits + row * fps, fps);
+  table->row_count++;
+  return row;
+}
+
+/**
+ * Returns the row of the provided nonnegative speed, computing it if this speed was never seen before.
+ */
+size_t movement_table_find(MovementTable *table, const int speed) {
+  size_t slot = find_slot(table, speed);
+  if (table->slots[slot] == EMPTY_SLOT) {
+    /* Keep the load factor at most one half, so that probe sequences stay short. */
+    if (2 * (table->row_count + 1) > table->slot_count) {
+      grow_slots(table);
+      slot = find_slot(table, speed);
+    }
+    table->slots[slot] = add_row(table, speed);
+  }
+  return table->slots[slot];
+}
+
+/**
+ * Returns how many pixels something at the speed of the provided row should move in the provided frame.
+ */
+int movement_table_get(const MovementTable *const table, const size_t row, const unsigned long frame) {
+  const int fps = table->frames_per_second;
+  return table->movements[row * fps + frame % fps];
+}
+
+/**
+ * Returns after how many frames something at the speed of the provided row moves again after the provided frame.
+ *
+ * This is between 1 and frames_per_second for nonzero speeds and 0 for the zero speed, which never moves.
+ */
+int movement_table_get_wait(const MovementTable *const table, const size_t row, const unsigned long frame) {
+  const int fps = table->frames_per_second;
+  return table->waits[row * fps + frame % fps];
+}
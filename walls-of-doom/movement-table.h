@@ -0,0 +1,56 @@
+#ifndef MOVEMENT_TABLE_H
+#define MOVEMENT_TABLE_H
+
+#include <stdlib.h>
+
+/**
+ * A cache of how many pixels something moving at a given speed should move in each frame.
+ *
+ * Speeds are in pixels per second. After f frames, something moving at speed s should have moved f * s / F pixels,
+ * rounded down, where F is the number of frames per second, so in frame f it moves floor(f * s / F) -
+ * floor((f - 1) * s / F) pixels. This depends only on f % F and s, so it is computed once for each speed, using
+ * integer arithmetic only.
+ *
+ * Each speed gets a row of F movements. Rows are never moved or removed, so row numbers remain valid.
+ */
+
+typedef struct MovementTable {
+  int frames_per_second;
+  size_t row_count;
+  size_t row_capacity;
+  /* The speed of each row. */
+  int *speeds;
+  /* The movements of each row, one for every frame in a second. */
+  int *movements;
+  /* How many frames after each frame of each row come before the next frame with movement, or 0 if there is none. */
+  int *waits;
+  /* An open addressing hash table mapping speeds to rows. */
+  size_t slot_count;
+  long *slots;
+} MovementTable;
+
+/**
+ * Creates a new empty MovementTable for the provided number of frames per second.
+ */
+MovementTable *create_movement_table(const int frames_per_second);
+
+MovementTable *destroy_movement_table(MovementTable *table);
+
+/**
+ * Returns the row of the provided nonnegative speed, computing it if this speed was never seen before.
+ */
+size_t movement_table_find(MovementTable *table, const int speed);
+
+/**
+ * Returns how many pixels something at the speed of the provided row should move in the provided frame.
+ */
+int movement_table_get(const MovementTable *const table, const size_t row, const unsigned long frame);
+
+/**
+ * Returns after how many frames something at the speed of the provided row moves again after the provided frame.
+ *
+ * This is between 1 and frames_per_second for nonzero speeds and 0 for the zero speed, which never moves.
+ */
+int movement_table_get_wait(const MovementTable *const table, const size_t row, const unsigned long frame);
+
+#endif
@@ -0,0 +1,233 @@
+#include "packed-matrix.h"
+#include "memory.h"
+#include <string.h>
+
+#define PACKED_WORD_FULL (~(PackedWord)0)
+
+PackedMatrix *create_packed_matrix(const int width, const int height) {
+  PackedMatrix *matrix = resize_memory(NULL, sizeof(PackedMatrix));
+  size_t word_count;
+  matrix->width = width;
+  matrix->height = height;
+  matrix->words_per_row = (width + PACKED_WORD_BITS - 1) / PACKED_WORD_BITS;
+  word_count = matrix->words_per_row * height;
+  matrix->words = resize_memory(NULL, sizeof(PackedWord) * word_count);
+  memset(matrix->words, 0, sizeof(PackedWord) * word_count);
+  return matrix;
+}
+
+PackedMatrix *destroy_packed_matrix(PackedMatrix *matrix) {
+  if (matrix != NULL) {
+    matrix->words = resize_memory(matrix->words, 0);
+  }
+  return resize_memory(matrix, 0);
+}
+
+/**
+ * Clips the rectangle to the matrix, returning 0 if nothing is left of it.
+ */
+static int clip_rectangle(const PackedMatrix *const matrix, int *x, int *y, int *w, int *h) {
+  if (*x < 0) {
+    *w += *x;
+    *x = 0;
+  }
+  if (*y < 0) {
+    *h += *y;
+    *y = 0;
+  }
+  if (*x + *w > matrix->width) {
+    *w = matrix->width - *x;
+  }
+  if (*y + *h > matrix->height) {
+    *h = matrix->height - *y;
+  }
+  return *w > 0 && *h > 0;
+}
+
+/**
+ * Returns a word with the bits in [from, to) set.
+ *
+ * Requires that 0 <= from < to <= PACKED_WORD_BITS.
+ */
+static PackedWord make_mask(const size_t from, const size_t to) {
+  return (PACKED_WORD_FULL >> (PACKED_WORD_BITS - (to - from))) << from;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+
+static int find_lowest_bit(const PackedWord word) { return __builtin_ctzl(word); }
+
+static int find_highest_bit(const PackedWord word) { return PACKED_WORD_BITS - 1 - __builtin_clzl(word); }
+
+#else
+
+static int find_lowest_bit(PackedWord word) {
+  int bit = 0;
+  while (!(word & 1)) {
+    word >>= 1;
+    bit++;
+  }
+  return bit;
+}
+
+static int find_highest_bit(PackedWord word) {
+  int bit = 0;
+  while (word >>= 1) {
+    bit++;
+  }
+  return bit;
+}
+
+#endif
+
+static PackedWord *get_row(const PackedMatrix *const matrix, const int y) {
+  return matrix->words + matrix->words_per_row * y;
+}
+
+/**
+ * Returns 1 if the cell at (x, y) is occupied and 0 otherwise.
+ */
+int packed_matrix_get(const PackedMatrix *const matrix, const int x, const int y) {
+  if (x < 0 || y < 0 || x >= matrix->width || y >= matrix->height) {
+    return 0;
+  }
+  return (get_row(matrix, y)[x / PACKED_WORD_BITS] >> (x % PACKED_WORD_BITS)) & 1;
+}
+
+static void fill_row(PackedWord *row, const size_t from, const size_t to, const int value) {
+  const size_t first = from / PACKED_WORD_BITS;
+  const size_t last = (to - 1) / PACKED_WORD_BITS;
+  const size_t first_bit = from % PACKED_WORD_BITS;
+  const size_t last_bit = (to - 1) % PACKED_WORD_BITS + 1;
+  PackedWord mask;
+  size_t i;
+  for (i = first; i <= last; i++) {
+    mask = make_mask(i == first ? first_bit : 0, i == last ? last_bit : PACKED_WORD_BITS);
+    if (value) {
+      row[i] |= mask;
+    } else {
+      row[i] &= ~mask;
+    }
+  }
+}
+
+/**
+ * Marks all cells of the rectangle as occupied (if value is nonzero) or free (if value is zero).
+ */
+void packed_matrix_fill(PackedMatrix *matrix, int x, int y, int w, int h, const int value) {
+  int j;
+  if (!clip_rectangle(matrix, &x, &y, &w, &h)) {
+    return;
+  }
+  for (j = y; j < y + h; j++) {
+    fill_row(get_row(matrix, j), x, x + w, value);
+  }
+}
+
+static int is_row_free(const PackedWord *row, const size_t from, const size_t to) {
+  const size_t first = from / PACKED_WORD_BITS;
+  const size_t last = (to - 1) / PACKED_WORD_BITS;
+  const size_t first_bit = from % PACKED_WORD_BITS;
+  const size_t last_bit = (to - 1) % PACKED_WORD_BITS + 1;
+  size_t i;
+  if (first == last) {
+    return !(row[first] & make_mask(first_bit, last_bit));
+  }
+  if (row[first] & make_mask(first_bit, PACKED_WORD_BITS)) {
+    return 0;
+  }
+  for (i = first + 1; i < last; i++) {
+    if (row[i]) {
+      return 0;
+    }
+  }
+  return !(row[last] & make_mask(0, last_bit));
+}
+
+/**
+ * Evaluates whether or not all cells of the rectangle are free.
+ */
+int packed_matrix_is_free(const PackedMatrix *const matrix, int x, int y, int w, int h) {
+  int j;
+  if (!clip_rectangle(matrix, &x, &y, &w, &h)) {
+    return 1;
+  }
+  for (j = y; j < y + h; j++) {
+    if (!is_row_free(get_row(matrix, j), x, x + w)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/**
+ * Returns the first occupied cell of the row in [from, to), or to if there is none.
+ */
+static int find_first_in_row(const PackedWord *row, const size_t from, const size_t to) {
+  const size_t first = from / PACKED_WORD_BITS;
+  const size_t last = (to - 1) / PACKED_WORD_BITS;
+  PackedWord word;
+  size_t i;
+  for (i = first; i <= last; i++) {
+    word = row[i] & make_mask(i == first ? from % PACKED_WORD_BITS : 0,
+                              i == last ? (to - 1) % PACKED_WORD_BITS + 1 : PACKED_WORD_BITS);
+    if (word) {
+      return (int)(i * PACKED_WORD_BITS) + find_lowest_bit(word);
+    }
+  }
+  return (int)to;
+}
+
+/**
+ * Returns the last occupied cell of the row in [from, to), or from - 1 if there is none.
+ */
+static int find_last_in_row(const PackedWord *row, const size_t from, const size_t to) {
+  const size_t first = from / PACKED_WORD_BITS;
+  const size_t last = (to - 1) / PACKED_WORD_BITS;
+  PackedWord word;
+  size_t i;
+  for (i = last + 1; i > first; i--) {
+    word = row[i - 1] & make_mask(i - 1 == first ? from % PACKED_WORD_BITS : 0,
+                                  i - 1 == last ? (to - 1) % PACKED_WORD_BITS + 1 : PACKED_WORD_BITS);
+    if (word) {
+      return (int)((i - 1) * PACKED_WORD_BITS) + find_highest_bit(word);
+    }
+  }
+  return (int)from - 1;
+}
+
+/**
+ * Returns the leftmost column of the rectangle with an occupied cell, or x + w if all of its cells are free.
+ */
+int packed_matrix_find_first(const PackedMatrix *const matrix, int x, int y, int w, int h) {
+  const int none = x + w;
+  int found;
+  int j;
+  if (!clip_rectangle(matrix, &x, &y, &w, &h)) {
+    return none;
+  }
+  found = x + w;
+  /* Each row only needs to be searched up to the best column found so far. */
+  for (j = y; j < y + h && found > x; j++) {
+    found = find_first_in_row(get_row(matrix, j), x, found);
+  }
+  return found == x + w ? none : found;
+}
+
+/**
+ * Returns the rightmost column of the rectangle with an occupied cell, or x - 1 if all of its cells are free.
+ */
+int packed_matrix_find_last(const PackedMatrix *const matrix, int x, int y, int w, int h) {
+  const int none = x - 1;
+  int found;
+  int j;
+  if (!clip_rectangle(matrix, &x, &y, &w, &h)) {
+    return none;
+  }
+  found = x - 1;
+  /* Each row only needs to be searched down to the best column found so far. */
+  for (j = y; j < y + h && found < x + w - 1; j++) {
+    found = find_last_in_row(get_row(matrix, j), found + 1, x + w);
+  }
+  return found == x - 1 ? none : found;
+}
@@ -0,0 +1,60 @@
+#ifndef PACKED_MATRIX_H
+#define PACKED_MATRIX_H
+
+#include <limits.h>
+#include <stdlib.h>
+
+/**
+ * A bit-packed occupancy matrix.
+ *
+ * Each cell takes a single bit and each row is stored as a contiguous run of machine words, so that rectangle queries
+ * can test a whole word (64 cells on LP64 systems) at once.
+ *
+ * All coordinates are relative to the top left corner of the matrix. Cells outside of the matrix are always free and
+ * writes to them are ignored.
+ */
+
+typedef unsigned long PackedWord;
+
+#define PACKED_WORD_BITS (sizeof(PackedWord) * CHAR_BIT)
+
+typedef struct PackedMatrix {
+  int width;
+  int height;
+  size_t words_per_row;
+  PackedWord *words;
+} PackedMatrix;
+
+/**
+ * Creates a new PackedMatrix with all cells free.
+ */
+PackedMatrix *create_packed_matrix(const int width, const int height);
+
+PackedMatrix *destroy_packed_matrix(PackedMatrix *matrix);
+
+/**
+ * Returns 1 if the cell at (x, y) is occupied and 0 otherwise.
+ */
+int packed_matrix_get(const PackedMatrix *const matrix, const int x, const int y);
+
+/**
+ * Marks all cells of the rectangle as occupied (if value is nonzero) or free (if value is zero).
+ */
+void packed_matrix_fill(PackedMatrix *matrix, int x, int y, int w, int h, const int value);
+
+/**
+ * Evaluates whether or not all cells of the rectangle are free.
+ */
+int packed_matrix_is_free(const PackedMatrix *const matrix, int x, int y, int w, int h);
+
+/**
+ * Returns the leftmost column of the rectangle with an occupied cell, or x + w if all of its cells are free.
+ */
+int packed_matrix_find_first(const PackedMatrix *const matrix, int x, int y, int w, int h);
+
+/**
+ * Returns the rightmost column of the rectangle with an occupied cell, or x - 1 if all of its cells are free.
+ */
+int packed_matrix_find_last(const PackedMatrix *const matrix, int x, int y, int w, int h);
+
+#endif
@@ -2,7 +2,7 @@
 #include "logger.h"
 #include "random.h"
 
-Perk get_random_perk(void) { return random_integer(0, PERK_COUNT - 1); }
+Perk get_random_perk(RandomState *random) { return random_state_integer(random, 0, PERK_COUNT - 1); }
 
 int is_bonus_perk(const Perk perk) { return perk == PERK_BONUS_EXTRA_POINTS || perk == PERK_BONUS_EXTRA_LIFE; }
 
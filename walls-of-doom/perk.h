@@ -1,13 +1,16 @@
 #ifndef PERK_H
 #define PERK_H
 
+#include "random.h"
+#include "settings.h"
+
 #define PERK_INTERVAL_IN_SECONDS 30
-#define PERK_INTERVAL_IN_FRAMES (PERK_INTERVAL_IN_SECONDS * FPS)
+#define PERK_INTERVAL_IN_FRAMES (PERK_INTERVAL_IN_SECONDS * get_tick_rate())
 
 #define PERK_SCREEN_DURATION_IN_SECONDS 15
 #define PERK_PLAYER_DURATION_IN_SECONDS 10
-#define PERK_SCREEN_DURATION_IN_FRAMES (PERK_SCREEN_DURATION_IN_SECONDS * FPS)
-#define PERK_PLAYER_DURATION_IN_FRAMES (PERK_PLAYER_DURATION_IN_SECONDS * FPS)
+#define PERK_SCREEN_DURATION_IN_FRAMES (PERK_SCREEN_DURATION_IN_SECONDS * get_tick_rate())
+#define PERK_PLAYER_DURATION_IN_FRAMES (PERK_PLAYER_DURATION_IN_SECONDS * get_tick_rate())
 
 typedef enum Perk {
   PERK_POWER_INVINCIBILITY,
@@ -23,7 +26,7 @@ typedef enum Perk {
   PERK_NONE
 } Perk;
 
-Perk get_random_perk(void);
+Perk get_random_perk(RandomState *random);
 
 int is_bonus_perk(const Perk perk);
 
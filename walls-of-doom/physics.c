@@ -1,7 +1,7 @@
 #include "physics.h"
 #include "bank.h"
-#include "base-io.h"
 #include "constants.h"
+#include "fixed.h"
 #include "investment.h"
 #include "limits.h"
 #include "logger.h"
@@ -10,12 +10,11 @@
 #include "random.h"
 #include "score.h"
 #include "settings.h"
-#include <math.h>
 #include <stdio.h>
 #include <string.h>
 
 /* Should be the maximum frame count value for 5 seconds remaining. */
-#define MINIMUM_REMAINING_FRAMES_FOR_MESSAGE (6 * FPS - 1)
+#define MINIMUM_REMAINING_FRAMES_FOR_MESSAGE ((unsigned long)(6 * get_tick_rate() - 1))
 
 /* Extra level of indirection needed to expand macros before the conversion. */
 #define AS_STR(X) #X
@@ -25,6 +24,9 @@
 #define BUY_LIFE_FORMAT(PRICE) "Bought an extra life for " STR(PRICE) " points."
 #define BUY_LIFE_MESSAGE BUY_LIFE_FORMAT(BUY_LIFE_PRICE)
 
+/* Below this many platforms, waking up the worker threads costs more than updating the platforms. */
+#define MINIMUM_PARALLEL_PLATFORMS 64
+
 static BoundingBox derive_box(const Game *game, const int x, const int y) {
   BoundingBox box;
   box.min_x = x;
@@ -35,13 +37,7 @@ static BoundingBox derive_box(const Game *game, const int x, const int y) {
 }
 
 static int has_rigid_support(const Game *game, int x, int y, int w, int h) {
-  int i;
-  for (i = 0; i < w; i++) {
-    if (get_from_rigid_matrix(game, x + i, y + h)) {
-      return 1;
-    }
-  }
-  return 0;
+  return !is_rigid_matrix_region_free(game, x, y + h, w, 1);
 }
 
 static int is_over_platform(const Player *player, const Platform *const platform) {
@@ -55,16 +51,7 @@ static int is_over_platform(const Player *player, const Platform *const platform
 
 /* Width and height are the width and height of the matrix tile. */
 static int violates_rigid_matrix(const Game *game, int x, int y, int w, int h) {
-  int i;
-  int j;
-  for (i = 0; i < w; i++) {
-    for (j = 0; j < h; j++) {
-      if (get_from_rigid_matrix(game, x + i, y + j)) {
-        return 1;
-      }
-    }
-  }
-  return 0;
+  return !is_rigid_matrix_region_free(game, x, y, w, h);
 }
 
 /**
@@ -89,24 +76,68 @@ static int is_valid_move(const Game *const game, const int x, const int y) {
 }
 
 /**
- * Moves the player by the provided x and y directions.
+ * Returns how many pixels can be traveled from position in the given direction before reaching wall, or INT_MAX if
+ * wall is not ahead.
+ */
+static int get_steps_before_wall(const int position, const int direction, const int wall) {
+  const int steps = (wall - position) * direction;
+  return steps > 0 ? steps - 1 : INT_MAX;
+}
+
+/**
+ * Moves the player by up to dx pixels horizontally or up to dy pixels vertically, stopping before the first invalid
+ * position. Only one of dx and dy should be nonzero.
  *
- * This moves the player at most one position on each axis.
+ * This is equivalent to moving the player one pixel at a time, but if the player is at a valid position only the
+ * leading edge of the player needs to be checked, once for the whole move.
+ *
+ * Returns how many pixels the player moved.
  */
-static void move_player(Game *game, int x, int y) {
-  /* It is OK to reuse x and y to prevent multiple integers for the same axis.
-   */
-  /* Ignore magnitude, take just -1, 0, or 1. */
-  x = normalize(x);
-  y = normalize(y);
-  /* Just in case a compiler cannot optimize this case away. */
-  if (x == 0 && y == 0) {
-    return;
+int sweep_player(Game *game, const int dx, const int dy) {
+  Player *const player = game->player;
+  const BoundingBox *const box = game->box;
+  const int step_x = normalize(dx);
+  const int step_y = normalize(dy);
+  int distance = abs(dx) + abs(dy);
+  int moved = 0;
+  if (distance == 0) {
+    return 0;
+  }
+  if (!is_valid_move(game, player->x, player->y)) {
+    /* The player already overlaps something, so the leading edge is not enough. */
+    while (moved < distance) {
+      if (!is_valid_move(game, player->x + step_x * (moved + 1), player->y + step_y * (moved + 1))) {
+        break;
+      }
+      moved++;
+    }
+  } else {
+    if (player->perk == PERK_POWER_INVINCIBILITY) {
+      /* If it is invincible, it shouldn't move into walls. */
+      if (dx != 0) {
+        distance = min_int(distance, get_steps_before_wall(player->x, step_x, box->min_x - 1));
+        distance = min_int(distance, get_steps_before_wall(player->x, step_x, box->max_x + 2 - player->w));
+      } else {
+        distance = min_int(distance, get_steps_before_wall(player->y, step_y, box->min_y - 1));
+        distance = min_int(distance, get_steps_before_wall(player->y, step_y, box->max_y + 2 - player->h));
+      }
+    }
+    if (dx > 0) {
+      moved = get_rigid_matrix_free_columns(game, player->x + player->w, player->y, player->h, distance);
+    } else if (dx < 0) {
+      moved = get_rigid_matrix_free_columns(game, player->x - 1, player->y, player->h, -distance);
+    } else if (dy > 0) {
+      moved = get_rigid_matrix_free_rows(game, player->x, player->y + player->h, player->w, distance);
+    } else {
+      moved = get_rigid_matrix_free_rows(game, player->x, player->y - 1, player->w, -distance);
+    }
   }
-  if (is_valid_move(game, game->player->x + x, game->player->y + y)) {
-    game->player->x += x;
-    game->player->y += y;
+  if (dx != 0) {
+    player->x += step_x * moved;
+  } else {
+    player->y += step_y * moved;
   }
+  return moved;
 }
 
 /**
@@ -120,23 +151,15 @@ static void shove_player(Game *game, int x, int y, int standing) {
   if (game->player->physics) {
     /* Don't shove the player if he is hovering over a platform. */
     if (game->player->perk != PERK_POWER_LEVITATION || !standing) {
-      move_player(game, x, 0);
+      sweep_player(game, x, 0);
     }
   }
-  move_player(game, 0, y);
-}
-
-static int get_absolute_pending_movement(unsigned long frame, int speed) {
-  /* Should move slice after every frame. */
-  const double slice = speed / (double)FPS;
-  /* To reduce floating point error, normalize frame to [FPS, 2 FPS - 1]. */
-  frame = frame % FPS + FPS;
-  return floor(frame * slice) - floor((frame - 1) * slice);
+  sweep_player(game, 0, y);
 }
 
 static int get_pending_movement(const Game *const game, const int speed) {
-  const int normalized = normalize(speed);
-  return normalized * get_absolute_pending_movement(game->frame, abs(speed));
+  const size_t row = movement_table_find(game->movement_table, abs(speed));
+  return normalize(speed) * movement_table_get(game->movement_table, row, game->frame);
 }
 
 static void subtract_platform(Game *const game, Platform *const platform) {
@@ -147,25 +170,21 @@ static void add_platform(Game *const game, Platform *const platform) {
   modify_rigid_matrix_platform(game, platform, 1);
 }
 
-static int is_free_on_matrix(Game *const game, int x, int y, int w, int h) {
-  int i;
-  int j;
-  for (i = 0; i != w; i++) {
-    for (j = 0; j != h; j++) {
-      if (get_from_rigid_matrix(game, x + i, y + j)) {
-        return 0;
-      }
-    }
-  }
-  return 1;
-}
-
 /**
- * Returns whether or not the platform can be inserted in the game without
- * overlapping any existing platforms.
+ * Returns the platform the player stands on, or NULL if the player is not standing on one.
+ *
+ * Only the platforms in the row of tiles under the feet of the player are checked.
  */
-static int can_insert_platform(Game *const game, Platform *const p) {
-  return is_free_on_matrix(game, p->x, p->y, p->w, p->h);
+const Platform *get_supporting_platform(const Game *const game) {
+  const Player *const player = game->player;
+  const Platform *platform;
+  for (platform = get_first_platform_in_row(game, get_platform_row(game, player->y + player->h)); platform != NULL;
+       platform = get_next_platform_in_row(game, platform)) {
+    if (is_over_platform(player, platform)) {
+      return platform;
+    }
+  }
+  return NULL;
 }
 
 /**
@@ -185,89 +204,179 @@ static int is_standing_on_platform(const Game *const game) {
   return has_rigid_support(game, x, y, w, h);
 }
 
-static int is_in_front_of_platform(const Player *const player, const Platform *const platform) {
+/**
+ * Moves the platform horizontally by dx along its row, updating only the edges of the platform in the rigid matrix.
+ *
+ * This keeps the cached rigid body matrix in the Game object valid. The caller must have checked that the platform
+ * fits where it is moved to. Platforms only change rows when they are repositioned.
+ */
+static void move_platform(Game *const game, Platform *const platform, const int dx) {
+  shift_rigid_matrix_platform(game, platform, dx);
+  platform->x += dx;
+  mirror_platform(game, platform);
+}
+
+/**
+ * Returns how many pixels the platform can move in the direction of its speed before it hits another platform.
+ *
+ * At most pending pixels are checked, so this is also the largest value this function returns.
+ */
+static int get_platform_free_distance(const Game *const game, const Platform *const platform, const int pending) {
   if (platform->speed < 0) {
-    if (player->x + player->w != platform->x) {
-      return 0;
-    }
-  } else {
-    if (platform->x + platform->w != player->x) {
-      return 0;
-    }
+    return get_rigid_matrix_free_columns(game, platform->x - 1, platform->y, platform->h, -pending);
   }
-  if (player->y < platform->y + platform->h) {
-    if (player->y + player->h > platform->y) {
-      return 1;
-    }
+  return get_rigid_matrix_free_columns(game, platform->x + platform->w, platform->y, platform->h, pending);
+}
+
+/**
+ * Returns after how many pixels of movement the platform touches the side of the player, or INT_MAX if it never does.
+ */
+static int get_steps_until_in_front(const Player *const player, const Platform *const platform) {
+  int gap;
+  if (player->y >= platform->y + platform->h || player->y + player->h <= platform->y) {
+    return INT_MAX;
   }
-  return 0;
+  if (platform->speed < 0) {
+    gap = platform->x - (player->x + player->w);
+  } else {
+    gap = player->x - (platform->x + platform->w);
+  }
+  return gap < 0 ? INT_MAX : gap;
 }
 
-static int can_move_platform(Game *const game, Platform *p, int dx, int dy) {
-  int can_move = 1;
-  if (get_player_stops_platforms() && is_over_platform(game->player, p)) {
+/**
+ * Returns after how many pixels of movement the platform is under the player, or INT_MAX if it never is.
+ */
+static int get_steps_until_under(const Player *const player, const Platform *const platform) {
+  if (player->y + player->h != platform->y) {
+    return INT_MAX;
+  }
+  if (is_over_platform(player, platform)) {
     return 0;
   }
-  if (dx == 0 && dy == 0) {
-    return 1;
+  if (platform->speed < 0 && platform->x >= player->x + player->w) {
+    return platform->x - (player->x + player->w) + 1;
   }
-  /* There are two optimized paths for unidirectional movement. */
-  if (dx == 0) {
-    if (dy < 0) {
-      return is_free_on_matrix(game, p->x, p->y + dy, p->w, -dy);
-    }
-    if (dy > 0) {
-      return is_free_on_matrix(game, p->x, p->y + p->h, p->w, dy);
+  if (platform->speed > 0 && platform->x + platform->w <= player->x) {
+    return player->x - (platform->x + platform->w) + 1;
+  }
+  return INT_MAX;
+}
+
+/**
+ * Returns the most pixels that something at the provided speed moves in a single frame.
+ */
+static int get_maximum_movement(const int speed) { return (abs(speed) + get_tick_rate() - 1) / get_tick_rate(); }
+
+/**
+ * Predicts the first frame after the current one in which the platform may run into another platform.
+ *
+ * Platforms only collide with the platforms of their own row, and the platform ahead of this one is the only one it
+ * can run into, as no other platform can get past that one. Each frame, the gap between them shrinks by at most the
+ * most this platform moves in a frame plus, if it is approaching, the most the platform ahead moves in a frame. The
+ * platform ahead may still move in the current frame and in the predicted frame before this platform does.
+ *
+ * This must be called after the platform moved in the current frame.
+ */
+static void predict_collision(Game *const game, const size_t index) {
+  const Platform *const platform = game->platforms + index;
+  const Platform *ahead = NULL;
+  Platform *other;
+  int gap = INT_MAX;
+  int distance;
+  int approach;
+  for (other = get_first_platform_in_row(game, get_platform_row(game, platform->y)); other != NULL;
+       other = get_next_platform_in_row(game, other)) {
+    if (platform->speed > 0 && other->x >= platform->x + platform->w) {
+      distance = other->x - (platform->x + platform->w);
+    } else if (platform->speed < 0 && other->x + other->w <= platform->x) {
+      distance = platform->x - (other->x + other->w);
+    } else if (other != platform && other->x < platform->x + platform->w && other->x + other->w > platform->x) {
+      /* Platforms repositioned into a full screen may overlap, and then nothing can be predicted. */
+      game->collision_frames[index] = game->frame + 1;
+      return;
+    } else {
+      continue;
     }
-  } else if (dy == 0) {
-    if (dx < 0) {
-      return is_free_on_matrix(game, p->x + dx, p->y, -dx, p->h);
+    if (distance < gap) {
+      gap = distance;
+      ahead = other;
     }
-    if (dx > 0) {
-      return is_free_on_matrix(game, p->x + p->w, p->y, dx, p->h);
-    }
-  } else {
-    /* If the platform would intersect with another platform, do not move it. */
-    subtract_platform(game, p);
-    p->x += dx;
-    p->y += dy;
-    can_move = can_insert_platform(game, p);
-    p->x -= dx;
-    p->y -= dy;
-    add_platform(game, p);
   }
-  return can_move;
+  if (ahead == NULL) {
+    /* Nothing is ahead of the platform until a platform is added to its row, which invalidates this prediction. */
+    game->collision_frames[index] = ULONG_MAX;
+    return;
+  }
+  approach = normalize(ahead->speed) == -normalize(platform->speed) ? get_maximum_movement(ahead->speed) : 0;
+  if (gap < approach) {
+    game->collision_frames[index] = game->frame + 1;
+    return;
+  }
+  gap -= approach;
+  game->collision_frames[index] = game->frame + 1 + gap / (get_maximum_movement(platform->speed) + approach);
 }
 
 /**
- * This function is the ONLY right way to move a platform.
- *
- * This function keeps the cached rigid body matrix in the Game object valid.
+ * Forgets the collision predictions of all platforms in the row, so that they are made again when they next move.
  */
-static void move_platform(Game *const game, Platform *const platform, const int dx, const int dy) {
-  if (can_move_platform(game, platform, dx, dy)) {
-    subtract_platform(game, platform);
-    platform->x += dx;
-    platform->y += dy;
-    add_platform(game, platform);
+static void invalidate_row_collisions(Game *const game, const int row) {
+  Platform *platform;
+  for (platform = get_first_platform_in_row(game, row); platform != NULL;
+       platform = get_next_platform_in_row(game, platform)) {
+    game->collision_frames[platform - game->platforms] = 0;
   }
 }
 
-static void move_platform_horizontally(Game *const game, Platform *const platform) {
+/**
+ * Moves the platform as far as it can go this frame at once.
+ *
+ * This is equivalent to moving the platform one pixel at a time: the platform stops at the first obstacle (or under
+ * the player, if players stop platforms) and the player is shoved by as many pixels as the platform moves after they
+ * come into contact. The player is never in the way of the platform's own path, so the matrix checks made while
+ * shoving do not depend on where the platform is.
+ *
+ * Before the frame in which the platform may run into another one, its whole movement is known to be free. After that,
+ * the collision is predicted again only if the platform is not blocked, as blocked platforms would need a new
+ * prediction in the very next frame.
+ *
+ * Platforms which are not in the rows the player overlaps or stands on cannot touch the player, and then near_player
+ * may be 0 so that the player is not read at all, as another thread may be moving it.
+ */
+static void move_platform_horizontally(Game *const game, Platform *const platform, const int pending_movement,
+                                       const int near_player) {
   const int normalized_speed = normalize(platform->speed);
-  /* This could be made more efficient by handling each direction separately. */
-  int pending = abs(get_pending_movement(game, platform->speed));
-  while (pending) {
-    if (can_move_platform(game, platform, normalized_speed, 0)) {
-      if (is_in_front_of_platform(game->player, platform)) {
-        shove_player(game, normalized_speed, 0, 0);
-      }
-      if (is_over_platform(game->player, platform)) {
-        shove_player(game, normalized_speed, 0, 1);
-      }
-      move_platform(game, platform, normalized_speed, 0);
+  const int pending = abs(pending_movement);
+  const size_t index = platform - game->platforms;
+  int predict = 0;
+  int distance;
+  int contact;
+  int standing = 0;
+  if (pending == 0) {
+    return;
+  }
+  if (game->frame < game->collision_frames[index]) {
+    distance = pending;
+  } else {
+    distance = get_platform_free_distance(game, platform, pending);
+    predict = distance == pending;
+  }
+  contact = near_player ? get_steps_until_in_front(game->player, platform) : INT_MAX;
+  if (near_player && contact == INT_MAX) {
+    contact = get_steps_until_under(game->player, platform);
+    standing = 1;
+    if (get_player_stops_platforms()) {
+      distance = min_int(distance, contact);
     }
-    pending--;
+  }
+  if (contact < distance) {
+    shove_player(game, normalized_speed * (distance - contact), 0, standing);
+  }
+  if (distance > 0) {
+    move_platform(game, platform, normalized_speed * distance);
+  }
+  if (predict) {
+    predict_collision(game, index);
   }
 }
 
@@ -278,12 +387,12 @@ static void move_platform_horizontally(Game *const game, Platform *const platfor
  *
  * This algorithm is O(n) with respect to the number of lines.
  */
-int select_random_line_blindly(const unsigned char *lines, const int size) {
+int select_random_line_blindly(const unsigned char *lines, const int size, RandomState *random) {
   int count;
   int skip;
   int line;
   int i;
-  /* Be careful not to call random_integer with invalid parameters. */
+  /* Be careful not to call random_state_integer with invalid parameters. */
   if (size < 1) {
     return 0;
   }
@@ -296,16 +405,15 @@ int select_random_line_blindly(const unsigned char *lines, const int size) {
   }
   /* No empty lines, return any line. */
   if (count == 0) {
-    return random_integer(0, size - 1);
+    return random_state_integer(random, 0, size - 1);
   }
   /* Get a random value based on the count. */
-  skip = random_integer(0, count - 1);
-  line = 0;
-  while (lines[line] || skip != 0) {
+  skip = random_state_integer(random, 0, count - 1);
+  /* There are more than skip empty lines, so this never goes past the end. */
+  for (line = 0; lines[line] || skip != 0; line++) {
     if (!lines[line]) {
       skip--;
     }
-    line = (line + 1) % size;
   }
   return line;
 }
@@ -314,101 +422,96 @@ int select_random_line_blindly(const unsigned char *lines, const int size) {
  * From an array of lines occupancy states, selects at random one of the lines
  * which are the furthest away from any other occupied line.
  *
- * This algorithm is O(n) with respect to the number of lines.
+ * This algorithm is O(n) with respect to the number of lines and does not
+ * allocate memory.
  */
-int select_random_line_awarely(const unsigned char *lines, const int size) {
-  int *distances = NULL;
-  int maximum_distance = INT_MIN;
-  int count;
+int select_random_line_awarely(const unsigned char *lines, const int size, RandomState *random) {
+  int maximum_distance = 0;
+  int previous = -1;
+  int count = 0;
+  int distance;
   int skip;
-  int line;
+  int ties;
+  int run;
   int i;
-  /* Be careful not to call random_integer with invalid parameters. */
+  /* Be careful not to call random_state_integer with invalid parameters. */
   if (size < 1) {
     return 0;
   }
-  distances = resize_memory(distances, sizeof(int) * size);
-  /* First pass: calculate the distance to nearest occupied line above. */
-  for (i = 0; i < size; i++) {
-    if (lines[i]) {
-      distances[i] = 0;
-    } else {
-      if (i > 0) {
-        distances[i] = distances[i - 1] + 1;
-      } else {
-        distances[i] = 1;
-      }
-    }
-  }
-  /* Second pass: calculate the distance to nearest occupied line below. */
-  for (i = size - 1; i >= 0; i--) {
-    if (lines[i]) {
-      distances[i] = 0;
-    } else {
-      if (i < size - 1) {
-        /* Use the minimum distance to first occupied line above or below. */
-        distances[i] = min_int(distances[i], distances[i + 1] + 1);
-      } else {
-        distances[i] = 1;
+  /*
+   * Lines outside of the array count as occupied, so every empty line is in a run of empty lines between two occupied
+   * lines. The furthest lines of a run are in its middle: one line if its length is odd, two lines otherwise.
+   */
+  for (i = 0; i <= size; i++) {
+    if (i == size || lines[i]) {
+      run = i - previous - 1;
+      if (run > 0) {
+        distance = (run + 1) / 2;
+        ties = run % 2 ? 1 : 2;
+        if (distance > maximum_distance) {
+          maximum_distance = distance;
+          count = ties;
+        } else if (distance == maximum_distance) {
+          count += ties;
+        }
       }
+      previous = i;
     }
-    maximum_distance = max_int(maximum_distance, distances[i]);
   }
-  /* Count how many occurrences of the maximum distance there are. */
-  count = 0;
-  for (i = 0; i < size; i++) {
-    if (distances[i] == maximum_distance) {
-      count++;
-    }
+  /* No empty lines, so all lines are at distance zero. */
+  if (count == 0) {
+    return random_state_integer(random, 0, size - 1);
   }
   /* Get a random value based on the count. */
-  skip = random_integer(0, count - 1);
-  line = 0;
-  while (distances[line] != maximum_distance || skip != 0) {
-    if (distances[line] == maximum_distance) {
-      skip--;
+  skip = random_state_integer(random, 0, count - 1);
+  previous = -1;
+  for (i = 0; i <= size; i++) {
+    if (i == size || lines[i]) {
+      run = i - previous - 1;
+      if (run > 0 && (run + 1) / 2 == maximum_distance) {
+        ties = run % 2 ? 1 : 2;
+        if (skip < ties) {
+          return skip == 0 ? previous + maximum_distance : i - maximum_distance;
+        }
+        skip -= ties;
+      }
+      previous = i;
     }
-    line = (line + 1) % size;
   }
-  resize_memory(distances, 0);
-  return line;
+  /* Unreachable, as the second pass finds the same lines as the first one. */
+  return 0;
 }
 
+/**
+ * Moves a platform which left the bounding box to the side it came in from, in a row selected at random.
+ */
 static void reposition(Game *const game, Platform *const platform) {
   const BoundingBox *const box = game->box;
-  /* The occupied size may be smaller than the array actually is. */
-  const int occupied_size = (get_window_height() - 2 * get_bar_height()) / get_tile_height();
-  const int tile_h = game->tile_h;
-  unsigned char *occupied = NULL;
+  /* The platform index has one more row, for the last line of pixels of the box, which platforms are never put in. */
+  const int occupied_size = (get_logical_height() - 2 * get_bar_height()) / get_tile_height();
+  const int row = get_platform_row(game, platform->y);
   int line;
-  size_t i;
-  occupied = resize_memory(occupied, occupied_size);
-  memset(occupied, 0, occupied_size);
-  /* Build a table of occupied rows. */
-  for (i = 0; i < game->platform_count; i++) {
-    if (!platform_equals(game->platforms[i], *platform)) {
-      occupied[(game->platforms[i].y - box->min_y) / tile_h] = 1;
-    }
-  }
+  /* The platform is leaving its row, so it should not count towards its occupancy. */
+  unindex_platform(game, platform);
   if (get_reposition_algorithm() == REPOSITION_SELECT_BLINDLY) {
-    line = select_random_line_blindly(occupied, occupied_size);
+    line = select_random_line_blindly(game->platform_index->occupied, occupied_size, &game->engine->random);
   } else {
-    line = select_random_line_awarely(occupied, occupied_size);
+    line = select_random_line_awarely(game->platform_index->occupied, occupied_size, &game->engine->random);
   }
-  resize_memory(occupied, 0);
+  subtract_platform(game, platform);
+  /* The platform should be one tick inside the box. */
   if (platform->x > box->max_x) {
-    subtract_platform(game, platform);
-    /* The platform should be one tick inside the box. */
     platform->x = box->min_x - platform->w + 1;
-    platform->y = box->min_y + tile_h * line;
-    add_platform(game, platform);
-  } else if (platform->x + platform->w < box->min_x) {
-    subtract_platform(game, platform);
-    /* The platform should be one tick inside the box. */
+  } else {
     platform->x = box->max_x;
-    platform->y = box->min_y + tile_h * line;
-    add_platform(game, platform);
   }
+  platform->y = box->min_y + game->tile_h * line;
+  add_platform(game, platform);
+  reindex_platform(game, platform);
+  mirror_platform(game, platform);
+  forget_platform_position(game, platform);
+  invalidate_row_collisions(game, row);
+  invalidate_row_collisions(game, line);
 }
 
 /**
@@ -431,18 +534,200 @@ int is_out_of_bounding_box(Platform *const platform, const BoundingBox *const bo
   }
 }
 
-static void update_platform(Game *const game, Platform *const platform) {
-  move_platform_horizontally(game, platform);
+/**
+ * Computes how many pixels every platform should move in the provided frame.
+ *
+ * This is get_pending_movement written as a loop without branches or calls, so that it can be vectorized. The row of
+ * the movement table of each platform is kept up to date by mirror_platform_speed.
+ */
+static void compute_pending_movements(const Game *const game, const unsigned long frame) {
+  PlatformStore *const store = game->platform_store;
+  const int *const speed = store->speed;
+  const int *const movement_row = store->movement_row;
+  const int fps = game->movement_table->frames_per_second;
+  const int *const movements = game->movement_table->movements + frame % fps;
+  int *const pending = store->pending;
+  size_t i;
+  for (i = 0; i < store->count; i++) {
+    pending[i] = ((speed[i] > 0) - (speed[i] < 0)) * movements[movement_row[i] * fps];
+  }
+}
+
+/**
+ * Rebuilds the schedule of platform movements, starting at the provided frame.
+ *
+ * Each platform is scheduled for the first frame from then on in which it moves. Platforms which do not move are left
+ * out of the schedule.
+ */
+static void schedule_platforms_from(Game *const game, const unsigned long frame) {
+  const PlatformStore *const store = game->platform_store;
+  int wait;
+  size_t i;
+  /* Speeds only change along with a rebuild of the schedule, and collision predictions depend on them. */
+  for (i = 0; i < store->count; i++) {
+    game->collision_frames[i] = 0;
+  }
+  timing_wheel_reset(game->platform_wheel, frame);
+  compute_pending_movements(game, frame);
+  for (i = 0; i < store->count; i++) {
+    if (store->pending[i] != 0) {
+      timing_wheel_schedule(game->platform_wheel, i, frame);
+    } else {
+      wait = movement_table_get_wait(game->movement_table, store->movement_row[i], frame);
+      if (wait != 0) {
+        timing_wheel_schedule(game->platform_wheel, i, frame + wait);
+      }
+    }
+  }
+}
+
+/**
+ * Rebuilds the schedule of platform movements, starting at the current frame.
+ */
+void schedule_platforms(Game *const game) { schedule_platforms_from(game, game->frame); }
+
+static void update_platform(Game *const game, const size_t index, const int near_player) {
+  const size_t row = game->platform_store->movement_row[index];
+  Platform *const platform = game->platforms + index;
+  const int pending = movement_table_get(game->movement_table, row, game->frame);
+  move_platform_horizontally(game, platform, normalize(platform->speed) * pending, near_player);
   if (is_out_of_bounding_box(platform, game->box)) {
     reposition(game, platform);
   }
 }
 
+/**
+ * Evaluates whether or not the platform may leave the bounding box in this frame, which would reposition it.
+ */
+static int may_leave_bounding_box(const Game *const game, const size_t index) {
+  const Platform *const platform = game->platforms + index;
+  const size_t row = game->platform_store->movement_row[index];
+  const int pending = movement_table_get(game->movement_table, row, game->frame);
+  if (platform->speed < 0) {
+    return platform->x + platform->w - game->box->min_x < pending;
+  }
+  return game->box->max_x - platform->x < pending;
+}
+
+/**
+ * Returns the row whose group the platform is updated in, which is its own row unless the player is in the way.
+ */
+static int get_group_row(const Game *const game, const size_t index, const int first_player_row,
+                         const int last_player_row) {
+  const int row = get_platform_row(game, game->platforms[index].y);
+  if (row >= first_player_row && row <= last_player_row) {
+    return first_player_row;
+  }
+  return row;
+}
+
+static void update_platform_group(void *context, const size_t group) {
+  Game *const game = context;
+  size_t i;
+  for (i = game->group_starts[group]; i < game->group_starts[group + 1]; i++) {
+    update_platform(game, game->group_items[i], (int)group == game->player_group);
+  }
+}
+
+/**
+ * Updates the platforms, splitting them among the threads of the worker pool by row.
+ *
+ * Platforms only run into platforms of their own row, so the rows can be updated in any order as long as each row is
+ * updated in the order of the platform array. The rows which the player overlaps or stands on are kept together in a
+ * single group, as their platforms may shove the player, and the platforms of the other groups do not read the player
+ * at all. None of the platforms may leave the bounding box, as that would reposition it into an arbitrary row.
+ */
+static void update_platforms_by_row(Game *const game, const size_t *platforms, const size_t count) {
+  const Player *const player = game->player;
+  const int first_player_row = max_int(0, get_platform_row(game, player->y));
+  const int last_player_row = get_platform_row(game, player->y + player->h);
+  size_t group_count = 0;
+  size_t group;
+  size_t i;
+  int row;
+  if (count < MINIMUM_PARALLEL_PLATFORMS) {
+    for (i = 0; i < count; i++) {
+      update_platform(game, platforms[i], 1);
+    }
+    return;
+  }
+  /* Count the platforms of each group, numbering the groups as they are first seen. */
+  game->group_starts[0] = 0;
+  for (i = 0; i < count; i++) {
+    row = get_group_row(game, platforms[i], first_player_row, last_player_row);
+    if (game->row_groups[row] < 0) {
+      game->row_groups[row] = group_count++;
+      game->group_starts[group_count] = 0;
+    }
+    game->group_starts[game->row_groups[row] + 1]++;
+  }
+  for (group = 1; group <= group_count; group++) {
+    game->group_starts[group] += game->group_starts[group - 1];
+  }
+  /* Place the platforms, advancing the start of each group past them, and then shift the starts back. */
+  for (i = 0; i < count; i++) {
+    row = get_group_row(game, platforms[i], first_player_row, last_player_row);
+    game->group_items[game->group_starts[game->row_groups[row]]++] = platforms[i];
+  }
+  for (group = group_count; group > 0; group--) {
+    game->group_starts[group] = game->group_starts[group - 1];
+  }
+  game->group_starts[0] = 0;
+  game->player_group = first_player_row < game->platform_index->row_count ? game->row_groups[first_player_row] : -1;
+  for (i = 0; i < count; i++) {
+    game->row_groups[get_group_row(game, platforms[i], first_player_row, last_player_row)] = -1;
+  }
+  worker_pool_run(game->worker_pool, update_platform_group, game, group_count);
+}
+
+/**
+ * Updates the due platforms on the threads of the worker pool.
+ *
+ * The platforms which may leave the bounding box are updated alone, and the runs of platforms between them are updated
+ * by row, which gives the same results as updating all of them in the order of the platform array.
+ */
+static void update_due_platforms_in_parallel(Game *const game) {
+  const TimingWheel *const wheel = game->platform_wheel;
+  size_t start = 0;
+  size_t i;
+  for (i = 0; i < wheel->due_count; i++) {
+    if (may_leave_bounding_box(game, wheel->due[i])) {
+      update_platforms_by_row(game, wheel->due + start, i - start);
+      update_platform(game, wheel->due[i], 1);
+      start = i + 1;
+    }
+  }
+  update_platforms_by_row(game, wheel->due + start, wheel->due_count - start);
+}
+
+/**
+ * Updates the platforms which move in this frame.
+ *
+ * Platforms which do not move in a frame are not visited at all, which is exact because a platform which does not
+ * move cannot leave the bounding box or push the player. Due platforms are updated in the order of the platform array.
+ */
 void update_platforms(Game *const game) {
+  TimingWheel *const wheel = game->platform_wheel;
+  size_t row;
   size_t i;
   if (game->player->perk != PERK_POWER_TIME_STOP) {
-    for (i = 0; i < game->platform_count; i++) {
-      update_platform(game, game->platforms + i);
+    /* The schedule is stale after frames in which platforms were not updated, such as under Time Stop. */
+    if (wheel->frame != game->frame) {
+      schedule_platforms(game);
+    }
+    timing_wheel_take(wheel);
+    if (game->worker_pool != NULL) {
+      update_due_platforms_in_parallel(game);
+    } else {
+      for (i = 0; i < wheel->due_count; i++) {
+        update_platform(game, wheel->due[i], 1);
+      }
+    }
+    /* Speeds only change through curses, which rebuild the whole schedule. */
+    for (i = 0; i < wheel->due_count; i++) {
+      row = game->platform_store->movement_row[wheel->due[i]];
+      timing_wheel_schedule(wheel, wheel->due[i], game->frame + movement_table_get_wait(game->movement_table, row,
+                                                                                          game->frame));
     }
   }
 }
@@ -496,6 +781,7 @@ void reposition_player(Game *const game) {
   const int y = get_bounding_box_center_y(box);
   game->player->x = x;
   game->player->y = y;
+  forget_player_position(game);
 }
 
 /**
@@ -513,14 +799,33 @@ void conceive_bonus(Player *const player, const Perk perk) {
   }
 }
 
-static void accelerate_platform(Platform *const platform) { platform->speed = platform->speed + platform->speed / 2; }
+static void accelerate_platforms(PlatformStore *store) {
+  int *const speed = store->speed;
+  size_t i;
+  for (i = 0; i < store->count; i++) {
+    speed[i] = speed[i] + speed[i] / 2;
+  }
+}
 
-static void reverse_platform(Platform *const platform) { platform->speed = -platform->speed; }
+static void reverse_platforms(PlatformStore *store) {
+  int *const speed = store->speed;
+  size_t i;
+  for (i = 0; i < store->count; i++) {
+    speed[i] = -speed[i];
+  }
+}
 
-static void apply_to_platforms(Game *const game, void (*f)(Platform *const p)) {
+/**
+ * Copies the speeds computed in the platform store back to the platforms.
+ *
+ * Mirroring the speeds finds the movement table rows of the new speeds.
+ */
+static void load_platform_speeds(Game *const game) {
+  const int *const speed = game->platform_store->speed;
   size_t i;
-  for (i = 0; i != game->platform_count; ++i) {
-    f(game->platforms + i);
+  for (i = 0; i < game->platform_count; i++) {
+    game->platforms[i].speed = speed[i];
+    mirror_platform_speed(game, game->platforms + i);
   }
 }
 
@@ -530,9 +835,13 @@ static void apply_to_platforms(Game *const game, void (*f)(Platform *const p)) {
 void process_curse(Game *const game, const Perk perk) {
   if (is_curse_perk(perk)) {
     if (perk == PERK_CURSE_ACCELERATE_PLATFORMS) {
-      apply_to_platforms(game, accelerate_platform);
+      accelerate_platforms(game->platform_store);
+      load_platform_speeds(game);
+      schedule_platforms_from(game, game->platform_wheel->frame);
     } else if (perk == PERK_CURSE_REVERSE_PLATFORMS) {
-      apply_to_platforms(game, reverse_platform);
+      reverse_platforms(game->platform_store);
+      load_platform_speeds(game);
+      schedule_platforms_from(game, game->platform_wheel->frame);
     }
   } else {
     log_message("Called process_curse with a Perk that is not a curse!");
@@ -540,6 +849,7 @@ void process_curse(Game *const game, const Perk perk) {
 }
 
 void update_perk(Game *const game) {
+  RandomState *random = &game->engine->random;
   unsigned long next_perk_frame = game->perk_end_frame;
   int random_x;
   int random_y;
@@ -548,9 +858,9 @@ void update_perk(Game *const game) {
   if (game->played_frames == game->perk_end_frame) {
     game->perk = PERK_NONE;
   } else if (game->played_frames == next_perk_frame) {
-    game->perk = get_random_perk();
-    random_x = random_integer(0, get_window_width() - get_tile_width());
-    random_y = random_integer(get_bar_height(), get_window_height() - 2 * get_bar_height());
+    game->perk = get_random_perk(random);
+    random_x = random_state_integer(random, 0, get_logical_width() - get_tile_width());
+    random_y = random_state_integer(random, get_bar_height(), get_logical_height() - 2 * get_bar_height());
     game->perk_x = random_x;
     game->perk_y = random_y - random_y % get_tile_height();
     game->perk_end_frame = game->played_frames + PERK_SCREEN_DURATION_IN_FRAMES;
@@ -558,18 +868,12 @@ void update_perk(Game *const game) {
 }
 
 /**
- * Moves the player according to the sign of its current speed if it can move in that direction.
+ * Moves the player according to its current speed if it can move in that direction.
+ *
+ * The sub-pixel part of the movement is kept in the player, so that analog speeds are not rounded to whole pixels.
  */
 void update_player_horizontal_position(Game *game) {
-  int pending_movement = get_pending_movement(game, game->player->speed_x);
-  while (pending_movement > 0) {
-    move_player(game, 1, 0);
-    pending_movement--;
-  }
-  while (pending_movement < 0) {
-    move_player(game, -1, 0);
-    pending_movement++;
-  }
+  sweep_player(game, advance_fixed(&game->player->remainder_x, game->player->speed_x, get_tick_rate()), 0);
 }
 
 static int is_jumping(const Player *const player) { return player->remaining_jump_height > 0; }
@@ -640,7 +944,7 @@ static void invest(Game *game, InvestmentMode mode) {
     player_score_sub(game->player, amount);
     investment->next = NULL;
     investment->amount = amount;
-    investment->end = game->played_frames + FPS * get_investment_period();
+    investment->end = game->played_frames + get_tick_rate() * get_investment_period();
     while (investments != NULL && investments->next != NULL) {
       investments = investments->next;
     }
@@ -653,17 +957,16 @@ static void invest(Game *game, InvestmentMode mode) {
 }
 
 void process_command(Game *game, Player *player) {
+  const long running_speed = PLAYER_RUNNING_SPEED * game->tile_w;
   double *table = player->table->status;
   if (table[COMMAND_LEFT]) {
-    double speed = -table[COMMAND_LEFT] * PLAYER_RUNNING_SPEED * game->tile_w;
-    player->speed_x = (int)speed;
+    player->speed_x = -proportion_to_fixed(table[COMMAND_LEFT]) * running_speed;
     player->physics = 1;
   } else if (table[COMMAND_RIGHT]) {
-    double speed = table[COMMAND_RIGHT] * PLAYER_RUNNING_SPEED * game->tile_w;
-    player->speed_x = (int)speed;
+    player->speed_x = proportion_to_fixed(table[COMMAND_RIGHT]) * running_speed;
     player->physics = 1;
   } else {
-    player->speed_x = (int)0.0;
+    player->speed_x = 0;
   }
   if (table[COMMAND_JUMP]) {
     process_jump(game);
@@ -690,6 +993,7 @@ static void check_for_player_death(Game *game) {
     /* Unset physics collisions for the player. */
     player->physics = 0;
     player->speed_x = 0;
+    player->remainder_x = 0;
     player->can_double_jump = 0;
     player->remaining_jump_height = 0;
   }
@@ -714,10 +1018,10 @@ void update_player_vertical_position(Game *game) {
   if (is_jumping(game->player)) {
     if (can_move_up(game)) {
       pending = get_pending_movement(game, jumping_speed);
-      while (pending > 0) {
-        move_player(game, 0, -1);
-        game->player->remaining_jump_height--;
-        pending--;
+      if (pending > 0) {
+        /* The jump is consumed even if the player hits a platform on the way up. */
+        sweep_player(game, 0, -pending);
+        game->player->remaining_jump_height -= pending;
       }
     } else {
       game->player->remaining_jump_height = 0;
@@ -728,9 +1032,8 @@ void update_player_vertical_position(Game *game) {
     } else {
       pending = get_pending_movement(game, falling_speed);
     }
-    while (pending > 0) {
-      move_player(game, 0, 1);
-      pending--;
+    if (pending > 0) {
+      sweep_player(game, 0, pending);
     }
   }
 }
@@ -754,7 +1057,7 @@ static void write_perk_faded_message(Game *game, const Perk perk) {
 }
 
 static void write_perk_fading_message(Game *game, const Perk perk, const unsigned long remaining_frames) {
-  const int seconds = remaining_frames / FPS;
+  const int seconds = remaining_frames / get_tick_rate();
   char message[MAXIMUM_STRING_SIZE];
   const char *perk_name = get_perk_name(perk);
   if (seconds < 1) {
@@ -829,8 +1132,8 @@ static void update_player_graphics(Game *game) {
 }
 
 void update_player(Game *game, Player *player) {
-  profiler_begin("update_player");
-  if (player->physics) {
+  profiler_begin(game->engine->profiler, "update_player");
+  if (player->physics && game->engine->logging) {
     log_player_score(game->played_frames, player->score);
   }
   update_player_graphics(game);
@@ -845,5 +1148,5 @@ void update_player(Game *game, Player *player) {
   /* Enable double jump if the player is standing over a platform. */
   update_double_jump(game);
   check_for_player_death(game);
-  profiler_end("update_player");
+  profiler_end(game->engine->profiler, "update_player");
 }
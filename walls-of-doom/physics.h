@@ -15,15 +15,21 @@
  *
  * This algorithm is O(n) with respect to the number of lines.
  */
-int select_random_line_blindly(const unsigned char *lines, const int size);
+int select_random_line_blindly(const unsigned char *lines, const int size, RandomState *random);
 
 /**
  * From an array of lines occupancy states, selects at random one of the lines
  * which are the furthest away from any other occupied line.
  *
- * This algorithm is O(n) with respect to the number of lines.
+ * This algorithm is O(n) with respect to the number of lines and does not
+ * allocate memory.
+ */
+int select_random_line_awarely(const unsigned char *lines, const int size, RandomState *random);
+
+/**
+ * Rebuilds the schedule of platform movements, starting at the current frame.
  */
-int select_random_line_awarely(const unsigned char *lines, const int size);
+void schedule_platforms(Game *const game);
 
 void update_platforms(Game *const game);
 
@@ -31,8 +37,21 @@ void update_perk(Game *const game);
 
 void update_player(Game *game, Player *player);
 
+/**
+ * Moves the player by up to dx pixels horizontally or up to dy pixels vertically, stopping before the first invalid
+ * position, as if it moved one pixel at a time. Only one of dx and dy should be nonzero.
+ *
+ * Returns how many pixels the player moved.
+ */
+int sweep_player(Game *game, const int dx, const int dy);
+
 void reposition_player(Game *const game);
 
+/**
+ * Returns the platform the player stands on, or NULL if the player is not standing on one.
+ */
+const Platform *get_supporting_platform(const Game *const game);
+
 /**
  * Conceives a bonus perk to the player.
  */
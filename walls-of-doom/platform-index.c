@@ -0,0 +1,92 @@
+#include "platform-index.h"
+#include "memory.h"
+#include "numeric.h"
+
+PlatformIndex *create_platform_index(const int row_count, const size_t platform_count) {
+  PlatformIndex *index = resize_memory(NULL, sizeof(PlatformIndex));
+  size_t i;
+  int row;
+  index->row_count = row_count;
+  index->platform_count = platform_count;
+  index->heads = resize_memory(NULL, sizeof(size_t) * max_int(1, row_count));
+  index->next = resize_memory(NULL, sizeof(size_t) * (platform_count ? platform_count : 1));
+  index->rows = resize_memory(NULL, sizeof(int) * (platform_count ? platform_count : 1));
+  index->counts = resize_memory(NULL, sizeof(size_t) * max_int(1, row_count));
+  index->occupied = resize_memory(NULL, sizeof(unsigned char) * max_int(1, row_count));
+  for (row = 0; row < row_count; row++) {
+    index->heads[row] = PLATFORM_INDEX_NONE;
+    index->counts[row] = 0;
+    index->occupied[row] = 0;
+  }
+  for (i = 0; i < platform_count; i++) {
+    index->next[i] = PLATFORM_INDEX_NONE;
+    index->rows[i] = -1;
+  }
+  return index;
+}
+
+PlatformIndex *destroy_platform_index(PlatformIndex *index) {
+  if (index != NULL) {
+    index->heads = resize_memory(index->heads, 0);
+    index->next = resize_memory(index->next, 0);
+    index->rows = resize_memory(index->rows, 0);
+    index->counts = resize_memory(index->counts, 0);
+    index->occupied = resize_memory(index->occupied, 0);
+  }
+  return resize_memory(index, 0);
+}
+
+static void unlink_platform(PlatformIndex *index, const size_t platform) {
+  const int row = index->rows[platform];
+  size_t *link = index->heads + row;
+  /* Rows usually hold very few platforms, so walking the list is cheap. */
+  while (*link != platform) {
+    link = index->next + *link;
+  }
+  *link = index->next[platform];
+  index->next[platform] = PLATFORM_INDEX_NONE;
+  index->rows[platform] = -1;
+  index->counts[row]--;
+  index->occupied[row] = index->counts[row] != 0;
+}
+
+/**
+ * Moves the platform to the provided row, removing it from the row it was in before.
+ *
+ * Passing -1 as the row only removes the platform from the index.
+ */
+void platform_index_set_row(PlatformIndex *index, const size_t platform, const int row) {
+  if (index->rows[platform] == row) {
+    return;
+  }
+  if (index->rows[platform] != -1) {
+    unlink_platform(index, platform);
+  }
+  if (row >= 0 && row < index->row_count) {
+    index->next[platform] = index->heads[row];
+    index->heads[row] = platform;
+    index->rows[platform] = row;
+    index->counts[row]++;
+    index->occupied[row] = 1;
+  }
+}
+
+/**
+ * Returns the row of the platform, or -1 if it is not indexed.
+ */
+int platform_index_get_row(const PlatformIndex *const index, const size_t platform) { return index->rows[platform]; }
+
+/**
+ * Returns the first platform in the row, or PLATFORM_INDEX_NONE if the row is empty.
+ */
+size_t platform_index_first(const PlatformIndex *const index, const int row) {
+  if (row < 0 || row >= index->row_count) {
+    return PLATFORM_INDEX_NONE;
+  }
+  return index->heads[row];
+}
+
+/**
+ * Returns the platform after the provided one in its row, or PLATFORM_INDEX_NONE if it is the last one.
+ */
+size_t platform_index_next(const PlatformIndex *const index, const size_t platform) { return index->next[platform]; }
@@ -0,0 +1,63 @@
+#ifndef PLATFORM_INDEX_H
+#define PLATFORM_INDEX_H
+
+#include <stdlib.h>
+
+/**
+ * An index of platforms by the row of tiles they are in.
+ *
+ * Platforms are referred to by their position in the platform array. Each row keeps an intrusive singly linked list of
+ * its platforms, so moving a platform to another row never allocates memory.
+ *
+ * Platforms in rows outside of [0, row_count) are not indexed.
+ *
+ * The index also counts the platforms of each row, so that the occupancy of the rows never has to be recomputed.
+ */
+
+#define PLATFORM_INDEX_NONE ((size_t)-1)
+
+typedef struct PlatformIndex {
+  int row_count;
+  size_t platform_count;
+  /* The first platform of each row. */
+  size_t *heads;
+  /* The next platform in the same row as each platform. */
+  size_t *next;
+  /* The row of each platform, or -1 if it is not indexed. */
+  int *rows;
+  /* How many platforms each row has. */
+  size_t *counts;
+  /* Whether or not each row has any platform, in the form line selection takes it. */
+  unsigned char *occupied;
+} PlatformIndex;
+
+/**
+ * Creates a new PlatformIndex with no indexed platforms.
+ */
+PlatformIndex *create_platform_index(const int row_count, const size_t platform_count);
+
+PlatformIndex *destroy_platform_index(PlatformIndex *index);
+
+/**
+ * Moves the platform to the provided row, removing it from the row it was in before.
+ *
+ * Passing -1 as the row only removes the platform from the index.
+ */
+void platform_index_set_row(PlatformIndex *index, const size_t platform, const int row);
+
+/**
+ * Returns the row of the platform, or -1 if it is not indexed.
+ */
+int platform_index_get_row(const PlatformIndex *const index, const size_t platform);
+
+/**
+ * Returns the first platform in the row, or PLATFORM_INDEX_NONE if the row is empty.
+ */
+size_t platform_index_first(const PlatformIndex *const index, const int row);
+
+/**
+ * Returns the platform after the provided one in its row, or PLATFORM_INDEX_NONE if it is the last one.
+ */
+size_t platform_index_next(const PlatformIndex *const index, const size_t platform);
+
+#endif
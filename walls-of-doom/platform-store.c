@@ -0,0 +1,46 @@
+#include "platform-store.h"
+#include "memory.h"
+
+/* How many arrays share the block of the store. */
+#define PLATFORM_STORE_ARRAYS 5
+
+PlatformStore *create_platform_store(const Platform *const platforms, const size_t count) {
+  PlatformStore *store = resize_memory(NULL, sizeof(PlatformStore));
+  /* Round each array up to a whole number of cache lines, so that the next one is aligned too. */
+  const size_t lines = (count * sizeof(int) + PLATFORM_STORE_ALIGNMENT - 1) / PLATFORM_STORE_ALIGNMENT;
+  const size_t stride = (lines ? lines : 1) * PLATFORM_STORE_ALIGNMENT / sizeof(int);
+  int *base;
+  size_t i;
+  store->count = count;
+  store->block = resize_memory(NULL, stride * sizeof(int) * PLATFORM_STORE_ARRAYS + PLATFORM_STORE_ALIGNMENT);
+  /* The conversion of the pointer is implementation-defined, but gives the address on all supported platforms. */
+  base = (int *)((char *)store->block + (PLATFORM_STORE_ALIGNMENT - (size_t)store->block % PLATFORM_STORE_ALIGNMENT) %
+                                            PLATFORM_STORE_ALIGNMENT);
+  store->x = base;
+  store->y = base + stride;
+  store->speed = base + 2 * stride;
+  store->movement_row = base + 3 * stride;
+  store->pending = base + 4 * stride;
+  for (i = 0; i < count; i++) {
+    platform_store_set(store, i, platforms + i);
+    store->movement_row[i] = 0;
+    store->pending[i] = 0;
+  }
+  return store;
+}
+
+PlatformStore *destroy_platform_store(PlatformStore *store) {
+  if (store != NULL) {
+    store->block = resize_memory(store->block, 0);
+  }
+  return resize_memory(store, 0);
+}
+
+/**
+ * Mirrors the state of the platform at the provided index.
+ */
+void platform_store_set(PlatformStore *store, const size_t index, const Platform *const platform) {
+  store->x[index] = platform->x;
+  store->y[index] = platform->y;
+  store->speed[index] = platform->speed;
+}
@@ -0,0 +1,45 @@
+#ifndef PLATFORM_STORE_H
+#define PLATFORM_STORE_H
+
+#include "platform.h"
+#include <stdlib.h>
+
+/**
+ * A structure of arrays mirror of the positions and speeds of the platforms of a game.
+ *
+ * The positions are copied as a whole before each frame, so that drawing can blend between frames. The speeds are
+ * changed by the curses and turned into the pending movements when the movement schedule is rebuilt, in plain loops
+ * over all platforms. Every array starts at a cache line boundary.
+ *
+ * The Platform array of the game remains the authoritative state, so every change to a platform must be mirrored here
+ * with platform_store_set.
+ */
+
+#define PLATFORM_STORE_ALIGNMENT 64
+
+typedef struct PlatformStore {
+  size_t count;
+  int *x;
+  int *y;
+  int *speed;
+  /* The row of the movement table for the speed of each platform. */
+  int *movement_row;
+  /* How many pixels each platform should move in the frame the store was last scheduled for. */
+  int *pending;
+  /* The allocation backing all of the arrays. */
+  void *block;
+} PlatformStore;
+
+/**
+ * Creates a new PlatformStore mirroring the provided platforms.
+ */
+PlatformStore *create_platform_store(const Platform *const platforms, const size_t count);
+
+PlatformStore *destroy_platform_store(PlatformStore *store);
+
+/**
+ * Mirrors the state of the platform at the provided index.
+ */
+void platform_store_set(PlatformStore *store, const size_t index, const Platform *const platform);
+
+#endif
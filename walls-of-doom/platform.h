@@ -2,6 +2,7 @@
 #define PLATFORM_H
 
 #include "box.h"
+#include "random.h"
 
 typedef struct Platform {
   int x;
@@ -12,7 +13,7 @@ typedef struct Platform {
 } Platform;
 
 void generate_platforms(Platform *platforms, const BoundingBox *const box, const int count, const int width,
-                        const int height);
+                        const int height, RandomState *random);
 
 /**
  * Compares two Platforms and evaluates whether or not they are the same.
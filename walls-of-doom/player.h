@@ -2,6 +2,7 @@
 #define PLAYER_H
 
 #include "command.h"
+#include "fixed.h"
 #include "graphics.h"
 #include "investment.h"
 #include "perk.h"
@@ -17,8 +18,11 @@ typedef struct Player {
   int y;
   int w;
   int h;
-  int speed_x;
+  /* The horizontal speed, in fixed-point pixels per second. */
+  Fixed speed_x;
   int speed_y;
+  /* How far right of x the player is, in units of 1 / (FIXED_ONE * get_tick_rate()) pixels. */
+  long remainder_x;
 
   /* Whether or not the player is being affected by physics. */
   int physics;
@@ -23,57 +23,88 @@ typedef struct ProfilerData {
   unsigned long frequency;
 } ProfilerData;
 
-static size_t table_size = 0;
+struct Profiler {
+  /**
+   * A very unoptimized table.
+   *
+   * Starts with size 0, increments in steps of one.
+   * Linear search is used to find the desired ProfilerData.
+   *
+   * Performance will degrade if too many different identifiers are used.
+   */
+  ProfilerData *table;
+  size_t table_size;
+};
+
+static Profiler *main_profiler = NULL;
 
 /**
- * A very unoptimized table.
- *
- * Starts with size 0, increments in steps of one.
- * Linear search is used to find the desired ProfilerData.
- *
- * Performance will degrade if too many different identifiers are used.
+ * Creates the main profiler, which collects the statistics of everything but the games simulated without a window.
  */
-static ProfilerData *table = NULL;
+Code initialize_profiler(void) {
+  main_profiler = create_profiler();
+  return CODE_OK;
+}
+
+Profiler *get_main_profiler(void) { return main_profiler; }
 
-Code initialize_profiler(void) { return CODE_OK; }
+Profiler *create_profiler(void) {
+  Profiler *profiler = resize_memory(NULL, sizeof(Profiler));
+  profiler->table = NULL;
+  profiler->table_size = 0;
+  return profiler;
+}
 
-ProfilerData *get_empty_data(const char *identifier) {
-  const size_t new_size = (table_size + 1) * sizeof(ProfilerData);
+Profiler *destroy_profiler(Profiler *profiler) {
+  if (profiler != NULL) {
+    profiler->table = resize_memory(profiler->table, 0);
+  }
+  return resize_memory(profiler, 0);
+}
+
+static ProfilerData *get_empty_data(Profiler *profiler, const char *identifier) {
+  const size_t new_size = (profiler->table_size + 1) * sizeof(ProfilerData);
   ProfilerData *reallocated_table;
   ProfilerData empty_data;
   copy_string(empty_data.identifier, identifier, MAXIMUM_DATA_IDENTIFIER_SIZE);
   empty_data.sum = 0;
   empty_data.stamp = 0;
   empty_data.frequency = 0;
-  reallocated_table = resize_memory(table, new_size);
+  reallocated_table = resize_memory(profiler->table, new_size);
   if (reallocated_table != NULL) {
-    table = reallocated_table;
-    table_size++;
-    table[table_size - 1] = empty_data;
+    profiler->table = reallocated_table;
+    profiler->table_size++;
+    profiler->table[profiler->table_size - 1] = empty_data;
   } else {
     log_message("Failed to reallocate table.");
   }
-  return table + table_size - 1;
+  return profiler->table + profiler->table_size - 1;
 }
 
-ProfilerData *get_data(const char *identifier) {
+static ProfilerData *get_data(Profiler *profiler, const char *identifier) {
   int found = 0;
   size_t i;
-  for (i = 0; i < table_size && !found; i++) {
-    found = string_equals(identifier, table[i].identifier);
+  for (i = 0; i < profiler->table_size && !found; i++) {
+    found = string_equals(identifier, profiler->table[i].identifier);
   }
   if (!found) {
-    return get_empty_data(identifier);
+    return get_empty_data(profiler, identifier);
   }
   /* Decrement because i is incremented before exiting the loop. */
-  return table + i - 1;
+  return profiler->table + i - 1;
 }
 
 /**
  * Updates the statistics about an identifier with a new millisecond count.
+ *
+ * Like the other profiling functions, this does nothing if the profiler is NULL.
  */
-void update_profiler(const char *identifier, const Milliseconds delta) {
-  ProfilerData *data = get_data(identifier);
+void update_profiler(Profiler *profiler, const char *identifier, const Milliseconds delta) {
+  ProfilerData *data;
+  if (profiler == NULL) {
+    return;
+  }
+  data = get_data(profiler, identifier);
   data->frequency++;
   data->sum += delta;
 }
@@ -81,17 +112,21 @@ void update_profiler(const char *identifier, const Milliseconds delta) {
 /**
  * Begins the profiling of the execution of the provided identifier.
  */
-void profiler_begin(const char *identifier) {
-  ProfilerData *data = get_data(identifier);
-  data->stamp = get_milliseconds();
+void profiler_begin(Profiler *profiler, const char *identifier) {
+  if (profiler == NULL) {
+    return;
+  }
+  get_data(profiler, identifier)->stamp = get_milliseconds();
 }
 
 /**
  * Ends the profiling of the execution of the provided identifier.
  */
-void profiler_end(const char *identifier) {
-  ProfilerData *data = get_data(identifier);
-  update_profiler(identifier, get_milliseconds() - data->stamp);
+void profiler_end(Profiler *profiler, const char *identifier) {
+  if (profiler == NULL) {
+    return;
+  }
+  update_profiler(profiler, identifier, get_milliseconds() - get_data(profiler, identifier)->stamp);
 }
 
 static double profiler_data_mean(const ProfilerData *const data) { return data->sum / (double)data->frequency; }
@@ -128,27 +163,32 @@ static int profiler_data_greater_than(const void *a, const void *b) {
   return -1;
 }
 
-void sort_table(void) { sort(table, table_size, sizeof(ProfilerData), profiler_data_greater_than); }
+static void sort_table(Profiler *profiler) {
+  sort(profiler->table, profiler->table_size, sizeof(ProfilerData), profiler_data_greater_than);
+}
 
-void write_statistics(void) {
+/**
+ * Appends the statistics of the profiler to the profiler file.
+ */
+void write_profiler_statistics(Profiler *profiler) {
   char path[MAXIMUM_PATH_SIZE];
   unsigned long frequency;
   double mean;
   size_t i;
   char *identifier;
   FILE *file;
-  if (table == NULL) {
+  if (profiler == NULL || profiler->table == NULL) {
     return;
   }
   get_full_path(path, PROFILER_FILE_NAME);
   file = fopen(path, "a");
   if (file) {
     /* Sort the table if we can write output. */
-    sort_table();
-    for (i = 0; i < table_size; i++) {
-      mean = profiler_data_mean(table + i);
-      frequency = table[i].frequency;
-      identifier = table[i].identifier;
+    sort_table(profiler);
+    for (i = 0; i < profiler->table_size; i++) {
+      mean = profiler_data_mean(profiler->table + i);
+      frequency = profiler->table[i].frequency;
+      identifier = profiler->table[i].identifier;
       fprintf(file, OUTPUT_FORMAT, identifier, mean, frequency);
     }
     fclose(file);
@@ -156,12 +196,11 @@ void write_statistics(void) {
 }
 
 /**
- * Saves all profiler data to disk and frees the allocated memory.
+ * Saves all data of the main profiler to disk and frees the allocated memory.
  */
 Code finalize_profiler(void) {
-  write_statistics();
-  table = resize_memory(table, 0);
-  table_size = 0;
+  write_profiler_statistics(main_profiler);
+  main_profiler = destroy_profiler(main_profiler);
   log_message("Freed the profiler table.");
   return CODE_OK;
 }
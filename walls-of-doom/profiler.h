@@ -4,25 +4,49 @@
 #include "clock.h"
 #include "code.h"
 
+/**
+ * Collects how long identified parts of the code take.
+ *
+ * A profiler is not shared between threads, so each game simulated on a thread of its own needs its own profiler, or
+ * none at all, as all profiling functions do nothing with a NULL profiler.
+ */
+typedef struct Profiler Profiler;
+
+/**
+ * Creates the main profiler, which collects the statistics of everything but the games simulated without a window.
+ */
 Code initialize_profiler(void);
 
+Profiler *get_main_profiler(void);
+
+Profiler *create_profiler(void);
+
+Profiler *destroy_profiler(Profiler *profiler);
+
 /**
  * Updates the statistics about an identifier with a new millisecond count.
+ *
+ * Like the other profiling functions, this does nothing if the profiler is NULL.
  */
-void update_profiler(const char *identifier, const Milliseconds delta);
+void update_profiler(Profiler *profiler, const char *identifier, const Milliseconds delta);
 
 /**
  * Begins the profiling of the execution of the provided identifier.
  */
-void profiler_begin(const char *identifier);
+void profiler_begin(Profiler *profiler, const char *identifier);
 
 /**
  * Ends the profiling of the execution of the provided identifier.
  */
-void profiler_end(const char *identifier);
+void profiler_end(Profiler *profiler, const char *identifier);
+
+/**
+ * Appends the statistics of the profiler to the profiler file.
+ */
+void write_profiler_statistics(Profiler *profiler);
 
 /**
- * Saves all profiler data to disk and frees the allocated memory.
+ * Saves all data of the main profiler to disk and frees the allocated memory.
  */
 Code finalize_profiler(void);
 
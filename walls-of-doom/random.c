@@ -10,30 +10,44 @@
 
 #define MAXIMUM_WORD_SIZE 32
 
-/* These state variables must be initialized so that they are not all zero. */
-static unsigned long x;
-static unsigned long y;
-static unsigned long z;
-static unsigned long w;
+/* The state of the global PRNG, which must be seeded so that it is not all zero. */
+static RandomState global_state;
 
-static unsigned long xorshift128(void) {
-  unsigned long t = x;
+static unsigned long xorshift128(RandomState *state) {
+  unsigned long t = state->x;
   /* Left shif overflow is undefined behavior in C. */
   t ^= t << 11;
   t ^= t >> 8;
-  x = y;
-  y = z;
-  z = w;
-  w ^= w >> 19;
-  w ^= t;
-  return w;
+  state->x = state->y;
+  state->y = state->z;
+  state->z = state->w;
+  state->w ^= state->w >> 19;
+  state->w ^= t;
+  return state->w;
 }
 
 void seed_random(void) {
   /* If tloc is a null pointer, no value is stored. */
-  x = (long)time(NULL);
+  global_state.x = (long)time(NULL);
 }
 
+/**
+ * Creates the state of a separate PRNG, seeded like seed_random seeds the global PRNG.
+ */
+RandomState create_random_state(const unsigned long seed) {
+  RandomState state;
+  state.x = seed;
+  state.y = 0;
+  state.z = 0;
+  state.w = 0;
+  return state;
+}
+
+/**
+ * Creates the state of a separate PRNG, seeded with the next number of the global PRNG.
+ */
+RandomState derive_random_state(void) { return create_random_state(xorshift128(&global_state)); }
+
 /**
  * Returns the next power of two bigger than the provided number.
  */
@@ -47,11 +61,11 @@ unsigned long find_next_power_of_two(unsigned long number) {
 }
 
 /**
- * Returns a random number in the range [minimum, maximum].
+ * Returns a random number in the range [minimum, maximum] from the PRNG with the provided state.
  *
  * Always returns 0 if maximum < minimum.
  */
-int random_integer(const int minimum, const int maximum) {
+int random_state_integer(RandomState *state, const int minimum, const int maximum) {
   /* Range should be a bigger type because the difference may overflow int. */
   unsigned long range;
   unsigned long next_power_of_two;
@@ -63,7 +77,7 @@ int random_integer(const int minimum, const int maximum) {
   range = maximum - minimum + 1;
   next_power_of_two = find_next_power_of_two(range);
   do {
-    value = xorshift128() % next_power_of_two;
+    value = xorshift128(state) % next_power_of_two;
   } while (value >= range);
   /*
    * Varies from
@@ -74,6 +88,13 @@ int random_integer(const int minimum, const int maximum) {
   return minimum + value;
 }
 
+/**
+ * Returns a random number in the range [minimum, maximum] from the global PRNG.
+ */
+int random_integer(const int minimum, const int maximum) {
+  return random_state_integer(&global_state, minimum, maximum);
+}
+
 /**
  * Copies the first word of a random line of the file to the destination.
  */
@@ -2,19 +2,47 @@
 #define RANDOM_H
 
 /**
- * Seeds the PRNG with the current time.
+ * The complete state of a PRNG, which determines all numbers it generates from then on.
+ *
+ * Besides the global PRNG, used by everything which is not simulated, each game has a PRNG of its own, so that games
+ * can be simulated at the same time without sharing any state.
+ */
+typedef struct RandomState {
+  unsigned long x;
+  unsigned long y;
+  unsigned long z;
+  unsigned long w;
+} RandomState;
+
+/**
+ * Seeds the global PRNG with the current time.
  *
  * This function can safely be called multiple times.
  */
 void seed_random(void);
 
+/**
+ * Creates the state of a separate PRNG, seeded like seed_random seeds the global PRNG.
+ */
+RandomState create_random_state(const unsigned long seed);
+
+/**
+ * Creates the state of a separate PRNG, seeded with the next number of the global PRNG.
+ */
+RandomState derive_random_state(void);
+
 /**
  * Returns the next power of two bigger than the provided number.
  */
 unsigned long find_next_power_of_two(unsigned long number);
 
 /**
- * Returns a random number in the range [minimum, maximum].
+ * Returns a random number in the range [minimum, maximum] from the PRNG with the provided state.
+ */
+int random_state_integer(RandomState *state, const int minimum, const int maximum);
+
+/**
+ * Returns a random number in the range [minimum, maximum] from the global PRNG.
  */
 int random_integer(const int minimum, const int maximum);
 
@@ -3,6 +3,7 @@
 #include "constants.h"
 #include "data.h"
 #include "high-io.h"
+#include "input.h"
 #include "logger.h"
 #include "memory.h"
 #include "numeric.h"
@@ -205,6 +206,6 @@ Code top_scores(SDL_Renderer *renderer, CommandTable *table) {
   Record records[MAXIMUM_DISPLAYED_RECORDS];
   const size_t count = read_records(records, MAXIMUM_DISPLAYED_RECORDS);
   print_records(count, records, renderer);
-  update_profiler("top_scores", get_milliseconds() - start);
+  update_profiler(get_main_profiler(), "top_scores", get_milliseconds() - start);
   return wait_for_input(table);
 }
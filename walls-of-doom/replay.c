@@ -0,0 +1,717 @@
+#include "replay.h"
+#include "logger.h"
+#include "memory.h"
+#include "random.h"
+#include "settings.h"
+#include "state-hash.h"
+#include <stdio.h>
+#include <string.h>
+
+#define REPLAY_MAGIC "WODR"
+#define REPLAY_MAGIC_SIZE 4
+#define REPLAY_VERSION 1
+
+/* Fits all the settings written by write_simulation_settings. */
+#define REPLAY_SETTINGS_SIZE 2048
+
+/* Records are only a few bytes long, so files are read and written through large buffers. */
+#define REPLAY_FILE_BUFFER_SIZE 65536
+
+/* Keys are either 0 or 1 and joystick axes are multiples of the inverse of this, so all values are stored exactly. */
+#define REPLAY_VALUE_SCALE 32768.0
+
+typedef enum ReplayTag {
+  REPLAY_TAG_END,
+  REPLAY_TAG_IDLE,
+  REPLAY_TAG_INPUT,
+  REPLAY_TAG_KEYFRAME,
+  REPLAY_TAG_HASH
+} ReplayTag;
+
+typedef struct Bytes {
+  unsigned char *data;
+  size_t size;
+  size_t capacity;
+} Bytes;
+
+struct ReplayWriter {
+  FILE *file;
+  /* The command table after the last frame, which the changes of the next frame are recorded against. */
+  double status[COMMAND_COUNT];
+  /* How many frames without changes were not written yet. */
+  unsigned long idle;
+  Bytes bytes;
+};
+
+struct ReplayReader {
+  FILE *file;
+  /* Where the first record starts. */
+  long start;
+  /* How many frames were replayed, which is the frame of the game if it was created for this replay. */
+  unsigned long frame;
+  /* How many frames are left in the current run of frames without changes. */
+  unsigned long idle;
+  /* Whether the replay holds hashes of the state, and whether and where the game first differed from one of them. */
+  int hashed;
+  int diverged;
+  unsigned long divergence;
+};
+
+static void put_byte(Bytes *bytes, const unsigned char byte) {
+  if (bytes->size == bytes->capacity) {
+    bytes->capacity = bytes->capacity ? 2 * bytes->capacity : 256;
+    bytes->data = resize_memory(bytes->data, bytes->capacity);
+  }
+  bytes->data[bytes->size++] = byte;
+}
+
+/**
+ * Writes an unsigned integer seven bits at a time, setting the high bit of all bytes but the last one.
+ */
+static void put_unsigned(Bytes *bytes, unsigned long value) {
+  while (value >= 0x80) {
+    put_byte(bytes, (unsigned char)(value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+  put_byte(bytes, (unsigned char)value);
+}
+
+/**
+ * Writes a signed integer, interleaving positive and negative values so that small magnitudes take few bytes.
+ */
+static void put_signed(Bytes *bytes, const long value) {
+  if (value < 0) {
+    put_unsigned(bytes, ((unsigned long)(-(value + 1)) << 1) | 1);
+  } else {
+    put_unsigned(bytes, (unsigned long)value << 1);
+  }
+}
+
+static void put_value(Bytes *bytes, const double value) {
+  put_unsigned(bytes, (unsigned long)(value * REPLAY_VALUE_SCALE + 0.5));
+}
+
+static int get_unsigned(FILE *file, unsigned long *value) {
+  int shift = 0;
+  int byte;
+  *value = 0;
+  do {
+    byte = getc(file);
+    if (byte == EOF) {
+      return 0;
+    }
+    *value |= (unsigned long)(byte & 0x7F) << shift;
+    shift += 7;
+  } while (byte & 0x80);
+  return 1;
+}
+
+static int get_signed(FILE *file, long *value) {
+  unsigned long encoded;
+  if (!get_unsigned(file, &encoded)) {
+    return 0;
+  }
+  if (encoded & 1) {
+    *value = -(long)(encoded >> 1) - 1;
+  } else {
+    *value = (long)(encoded >> 1);
+  }
+  return 1;
+}
+
+static int get_int(FILE *file, int *value) {
+  long read;
+  if (!get_signed(file, &read)) {
+    return 0;
+  }
+  *value = (int)read;
+  return 1;
+}
+
+static int get_value(FILE *file, double *value) {
+  unsigned long read;
+  if (!get_unsigned(file, &read)) {
+    return 0;
+  }
+  *value = read / REPLAY_VALUE_SCALE;
+  return 1;
+}
+
+static void write_bytes_to_file(ReplayWriter *writer) {
+  fwrite(writer->bytes.data, 1, writer->bytes.size, writer->file);
+  writer->bytes.size = 0;
+}
+
+static void put_random_state(Bytes *bytes, const RandomState state) {
+  put_unsigned(bytes, state.x);
+  put_unsigned(bytes, state.y);
+  put_unsigned(bytes, state.z);
+  put_unsigned(bytes, state.w);
+}
+
+static int get_random_state_from_file(FILE *file, RandomState *state) {
+  int read = 1;
+  read = read && get_unsigned(file, &state->x);
+  read = read && get_unsigned(file, &state->y);
+  read = read && get_unsigned(file, &state->z);
+  read = read && get_unsigned(file, &state->w);
+  return read;
+}
+
+/**
+ * Writes the state of the simulation at the start of the current frame.
+ *
+ * The status of the commands is the one after the last frame, as the changes of the current frame come after this.
+ */
+static void put_keyframe(Bytes *bytes, const Game *const game, const double *status) {
+  const Player *const player = game->player;
+  const Investment *investment;
+  unsigned long investment_count = 0;
+  size_t i;
+  put_unsigned(bytes, game->played_frames);
+  put_unsigned(bytes, game->next_played_frames_score);
+  put_random_state(bytes, game->engine->random);
+  put_signed(bytes, game->perk);
+  put_signed(bytes, game->perk_x);
+  put_signed(bytes, game->perk_y);
+  put_unsigned(bytes, game->perk_end_frame);
+  put_signed(bytes, player->x);
+  put_signed(bytes, player->y);
+  put_signed(bytes, player->speed_x);
+  put_signed(bytes, player->speed_y);
+  put_signed(bytes, player->remainder_x);
+  put_signed(bytes, player->physics);
+  put_signed(bytes, player->can_double_jump);
+  put_signed(bytes, player->remaining_jump_height);
+  put_signed(bytes, player->lives);
+  put_signed(bytes, player->score);
+  put_signed(bytes, player->perk);
+  put_unsigned(bytes, player->perk_end_frame);
+  for (investment = player->investments; investment != NULL; investment = investment->next) {
+    investment_count++;
+  }
+  put_unsigned(bytes, investment_count);
+  for (investment = player->investments; investment != NULL; investment = investment->next) {
+    put_unsigned(bytes, investment->end);
+    put_signed(bytes, investment->amount);
+  }
+  for (i = 0; i < COMMAND_COUNT; i++) {
+    put_value(bytes, status[i]);
+  }
+  put_unsigned(bytes, game->platform_count);
+  for (i = 0; i < game->platform_count; i++) {
+    put_signed(bytes, game->platforms[i].x);
+    put_signed(bytes, game->platforms[i].y);
+    put_signed(bytes, game->platforms[i].w);
+    put_signed(bytes, game->platforms[i].h);
+    put_signed(bytes, game->platforms[i].speed);
+  }
+}
+
+static void free_investments(Investment *investments) {
+  Investment *next;
+  while (investments != NULL) {
+    next = investments->next;
+    resize_memory(investments, 0);
+    investments = next;
+  }
+}
+
+/**
+ * Reads the investments into a new list, which is freed again if the list in the file is incomplete.
+ */
+static int get_investments(FILE *file, Investment **investments) {
+  Investment **last = investments;
+  unsigned long count;
+  unsigned long i;
+  long amount;
+  *investments = NULL;
+  if (!get_unsigned(file, &count)) {
+    return 0;
+  }
+  for (i = 0; i < count; i++) {
+    *last = resize_memory(NULL, sizeof(Investment));
+    (*last)->next = NULL;
+    if (!get_unsigned(file, &(*last)->end) || !get_signed(file, &amount)) {
+      free_investments(*investments);
+      *investments = NULL;
+      return 0;
+    }
+    (*last)->amount = amount;
+    last = &(*last)->next;
+  }
+  return 1;
+}
+
+/**
+ * Reads the platforms into a copy of the platforms of the game, so that the fields not in the file are kept.
+ */
+static int get_platforms(FILE *file, const Game *const game, Platform *platforms) {
+  unsigned long count;
+  size_t i;
+  int read = 1;
+  if (!get_unsigned(file, &count) || count != game->platform_count) {
+    return 0;
+  }
+  memcpy(platforms, game->platforms, sizeof(Platform) * game->platform_count);
+  for (i = 0; i < game->platform_count && read; i++) {
+    read = read && get_int(file, &platforms[i].x);
+    read = read && get_int(file, &platforms[i].y);
+    read = read && get_int(file, &platforms[i].w);
+    read = read && get_int(file, &platforms[i].h);
+    read = read && get_int(file, &platforms[i].speed);
+  }
+  return read;
+}
+
+/**
+ * Restores the state of the simulation written by put_keyframe.
+ *
+ * Everything is read into copies first, so that a damaged keyframe leaves the game as it was.
+ */
+static int get_keyframe(FILE *file, Game *game, const unsigned long frame) {
+  Game restored = *game;
+  Player player = *game->player;
+  Platform *platforms = resize_memory(NULL, sizeof(Platform) * game->platform_count);
+  double status[COMMAND_COUNT];
+  RandomState state;
+  long value = 0;
+  int read = 1;
+  size_t i;
+  /* The investments of the game are only freed once the ones in the file were read. */
+  player.investments = NULL;
+  restored.frame = frame;
+  read = read && get_unsigned(file, &restored.played_frames);
+  read = read && get_unsigned(file, &restored.next_played_frames_score);
+  read = read && get_random_state_from_file(file, &state);
+  read = read && get_signed(file, &value);
+  restored.perk = (Perk)value;
+  read = read && get_int(file, &restored.perk_x);
+  read = read && get_int(file, &restored.perk_y);
+  read = read && get_unsigned(file, &restored.perk_end_frame);
+  read = read && get_int(file, &player.x);
+  read = read && get_int(file, &player.y);
+  read = read && get_signed(file, &player.speed_x);
+  read = read && get_int(file, &player.speed_y);
+  read = read && get_signed(file, &player.remainder_x);
+  read = read && get_int(file, &player.physics);
+  read = read && get_int(file, &player.can_double_jump);
+  read = read && get_int(file, &player.remaining_jump_height);
+  read = read && get_int(file, &player.lives);
+  read = read && get_signed(file, &player.score);
+  read = read && get_signed(file, &value);
+  player.perk = (Perk)value;
+  read = read && get_unsigned(file, &player.perk_end_frame);
+  read = read && get_investments(file, &player.investments);
+  for (i = 0; i < COMMAND_COUNT; i++) {
+    read = read && get_value(file, &status[i]);
+  }
+  read = read && get_platforms(file, game, platforms);
+  if (!read) {
+    free_investments(player.investments);
+    resize_memory(platforms, 0);
+    return 0;
+  }
+  free_investments(game->player->investments);
+  *game->player = player;
+  memcpy(player.table->status, status, sizeof(status));
+  memcpy(restored.platforms, platforms, sizeof(Platform) * game->platform_count);
+  resize_memory(platforms, 0);
+  *game = restored;
+  game->engine->random = state;
+  game->message[0] = '\0';
+  game->message_end_frame = 0;
+  game->message_priority = 0;
+  rebuild_game(game);
+  return 1;
+}
+
+ReplayWriter *create_replay_writer(const char *filename, const Engine *const engine) {
+  char settings[REPLAY_SETTINGS_SIZE];
+  ReplayWriter *writer;
+  FILE *file = fopen(filename, "wb");
+  size_t i;
+  if (file == NULL) {
+    log_message("Failed to open the replay file for writing.");
+    return NULL;
+  }
+  setvbuf(file, NULL, _IOFBF, REPLAY_FILE_BUFFER_SIZE);
+  writer = resize_memory(NULL, sizeof(ReplayWriter));
+  writer->file = file;
+  for (i = 0; i < COMMAND_COUNT; i++) {
+    writer->status[i] = 0.0;
+  }
+  writer->idle = 0;
+  writer->bytes.data = NULL;
+  writer->bytes.size = 0;
+  writer->bytes.capacity = 0;
+  write_simulation_settings(settings, REPLAY_SETTINGS_SIZE);
+  fwrite(REPLAY_MAGIC, 1, REPLAY_MAGIC_SIZE, file);
+  put_unsigned(&writer->bytes, REPLAY_VERSION);
+  put_unsigned(&writer->bytes, strlen(settings));
+  write_bytes_to_file(writer);
+  fwrite(settings, 1, strlen(settings), file);
+  put_random_state(&writer->bytes, engine->random);
+  write_bytes_to_file(writer);
+  return writer;
+}
+
+static void write_idle_frames(ReplayWriter *writer) {
+  if (writer->idle > 0) {
+    put_byte(&writer->bytes, REPLAY_TAG_IDLE);
+    put_unsigned(&writer->bytes, writer->idle);
+    writer->idle = 0;
+  }
+}
+
+ReplayWriter *destroy_replay_writer(ReplayWriter *writer) {
+  if (writer != NULL) {
+    write_idle_frames(writer);
+    put_byte(&writer->bytes, REPLAY_TAG_END);
+    write_bytes_to_file(writer);
+    fclose(writer->file);
+    writer->bytes.data = resize_memory(writer->bytes.data, 0);
+  }
+  return resize_memory(writer, 0);
+}
+
+static void write_keyframe(ReplayWriter *writer, const Game *const game) {
+  Bytes keyframe;
+  keyframe.data = NULL;
+  keyframe.size = 0;
+  keyframe.capacity = 0;
+  put_keyframe(&keyframe, game, writer->status);
+  write_idle_frames(writer);
+  put_byte(&writer->bytes, REPLAY_TAG_KEYFRAME);
+  put_unsigned(&writer->bytes, game->frame);
+  put_unsigned(&writer->bytes, keyframe.size);
+  write_bytes_to_file(writer);
+  fwrite(keyframe.data, 1, keyframe.size, writer->file);
+  resize_memory(keyframe.data, 0);
+}
+
+/**
+ * Records the changes to the command table of the player since the last frame and simulates a frame.
+ */
+void record_game_step(ReplayWriter *writer, Game *const game) {
+  const double *status = game->player->table->status;
+  const unsigned long keyframe_period = REPLAY_KEYFRAME_PERIOD * get_tick_rate();
+  unsigned long changes = 0;
+  size_t i;
+  if (game->frame > 0 && game->frame % keyframe_period == 0) {
+    write_keyframe(writer, game);
+  }
+  for (i = 0; i < COMMAND_COUNT; i++) {
+    if (status[i] != writer->status[i]) {
+      changes++;
+    }
+  }
+  if (changes == 0) {
+    writer->idle++;
+  } else {
+    write_idle_frames(writer);
+    put_byte(&writer->bytes, REPLAY_TAG_INPUT);
+    put_unsigned(&writer->bytes, changes);
+    for (i = 0; i < COMMAND_COUNT; i++) {
+      if (status[i] != writer->status[i]) {
+        put_unsigned(&writer->bytes, i);
+        put_value(&writer->bytes, status[i]);
+      }
+    }
+    write_bytes_to_file(writer);
+  }
+  step_game(game, NULL, 0);
+  /* Simulating changes the table as well, such as when a jump is consumed. */
+  memcpy(writer->status, status, sizeof(writer->status));
+  if (get_state_hash_period() && game->frame % get_state_hash_period() == 0) {
+    write_idle_frames(writer);
+    put_byte(&writer->bytes, REPLAY_TAG_HASH);
+    put_unsigned(&writer->bytes, hash_game_state(game));
+    write_bytes_to_file(writer);
+  }
+}
+
+ReplayReader *create_replay_reader(const char *filename, Engine *engine) {
+  char magic[REPLAY_MAGIC_SIZE];
+  char settings[REPLAY_SETTINGS_SIZE];
+  char restored[REPLAY_SETTINGS_SIZE];
+  ReplayReader *reader;
+  RandomState state;
+  unsigned long version;
+  unsigned long length;
+  FILE *file = fopen(filename, "rb");
+  if (file == NULL) {
+    log_message("Failed to open the replay file for reading.");
+    return NULL;
+  }
+  setvbuf(file, NULL, _IOFBF, REPLAY_FILE_BUFFER_SIZE);
+  if (fread(magic, 1, REPLAY_MAGIC_SIZE, file) != REPLAY_MAGIC_SIZE || memcmp(magic, REPLAY_MAGIC, REPLAY_MAGIC_SIZE) ||
+      !get_unsigned(file, &version) || version != REPLAY_VERSION || !get_unsigned(file, &length) ||
+      length >= REPLAY_SETTINGS_SIZE || fread(settings, 1, length, file) != length ||
+      !get_random_state_from_file(file, &state)) {
+    log_message("Failed to read the replay header.");
+    fclose(file);
+    return NULL;
+  }
+  settings[length] = '\0';
+  parse_settings(settings);
+  /* Settings the game never parsed may be outside the limits parsing enforces, and then they cannot be restored. */
+  write_simulation_settings(restored, REPLAY_SETTINGS_SIZE);
+  if (strcmp(settings, restored)) {
+    log_message("Could not restore the settings of the replay exactly, so it may play differently.");
+  }
+  engine->random = state;
+  reader = resize_memory(NULL, sizeof(ReplayReader));
+  reader->file = file;
+  reader->start = ftell(file);
+  reader->frame = 0;
+  reader->idle = 0;
+  reader->hashed = 0;
+  reader->diverged = 0;
+  reader->divergence = 0;
+  return reader;
+}
+
+ReplayReader *destroy_replay_reader(ReplayReader *reader) {
+  if (reader != NULL) {
+    fclose(reader->file);
+  }
+  return resize_memory(reader, 0);
+}
+
+static int skip_keyframe(FILE *file) {
+  unsigned long frame;
+  unsigned long length;
+  return get_unsigned(file, &frame) && get_unsigned(file, &length) && !fseek(file, (long)length, SEEK_CUR);
+}
+
+/**
+ * Reads the changes of a frame and simulates it.
+ */
+static int replay_input(ReplayReader *reader, Game *const game) {
+  InputEvent events[COMMAND_COUNT];
+  unsigned long count;
+  unsigned long command;
+  unsigned long i;
+  if (!get_unsigned(reader->file, &count) || count > COMMAND_COUNT) {
+    return 0;
+  }
+  for (i = 0; i < count; i++) {
+    if (!get_unsigned(reader->file, &command) || command >= COMMAND_COUNT) {
+      return 0;
+    }
+    if (!get_value(reader->file, &events[i].value)) {
+      return 0;
+    }
+    events[i].command = (Command)command;
+    events[i].axis = 0;
+    events[i].time = 0;
+  }
+  step_game(game, events, count);
+  return 1;
+}
+
+/**
+ * Compares the state of the game with the hash recorded after the last frame, if there is one.
+ *
+ * Hashes are always written after the run of frames without changes they end, so there is none in the middle of one.
+ */
+static void check_hash(ReplayReader *reader, const Game *const game) {
+  unsigned long hash;
+  int tag;
+  if (reader->idle > 0) {
+    return;
+  }
+  tag = getc(reader->file);
+  if (tag != REPLAY_TAG_HASH) {
+    if (tag != EOF) {
+      ungetc(tag, reader->file);
+    }
+    return;
+  }
+  if (get_unsigned(reader->file, &hash)) {
+    reader->hashed = 1;
+    if (!reader->diverged && hash != hash_game_state(game)) {
+      reader->diverged = 1;
+      reader->divergence = game->frame;
+    }
+  }
+}
+
+/**
+ * Simulates the next frame of the replay, returning 0 if the replay has ended.
+ */
+int replay_game_step(ReplayReader *reader, Game *const game) {
+  unsigned long hash;
+  int tag;
+  while (reader->idle == 0) {
+    tag = getc(reader->file);
+    if (tag == REPLAY_TAG_IDLE) {
+      if (!get_unsigned(reader->file, &reader->idle)) {
+        return 0;
+      }
+    } else if (tag == REPLAY_TAG_KEYFRAME) {
+      if (!skip_keyframe(reader->file)) {
+        return 0;
+      }
+    } else if (tag == REPLAY_TAG_HASH) {
+      /* A hash before any frame of this replay was simulated has nothing to be compared with. */
+      if (!get_unsigned(reader->file, &hash)) {
+        return 0;
+      }
+    } else if (tag == REPLAY_TAG_INPUT) {
+      if (!replay_input(reader, game)) {
+        return 0;
+      }
+      reader->frame++;
+      check_hash(reader, game);
+      return 1;
+    } else {
+      /* Either the end of the replay or a damaged file. */
+      return 0;
+    }
+  }
+  reader->idle--;
+  step_game(game, NULL, 0);
+  reader->frame++;
+  check_hash(reader, game);
+  return 1;
+}
+
+/**
+ * Finds the last keyframe at or before the frame, without simulating anything.
+ *
+ * Returns the position of the keyframe in the file, or -1 if there is none.
+ */
+static long find_keyframe(ReplayReader *reader, const unsigned long frame) {
+  FILE *file = reader->file;
+  unsigned long scanned = 0;
+  unsigned long value;
+  unsigned long keyframe_frame;
+  unsigned long count;
+  unsigned long i;
+  long keyframe = -1;
+  long position;
+  int tag;
+  fseek(file, reader->start, SEEK_SET);
+  while (scanned <= frame) {
+    position = ftell(file);
+    tag = getc(file);
+    if (tag == REPLAY_TAG_IDLE) {
+      if (!get_unsigned(file, &value)) {
+        break;
+      }
+      scanned += value;
+    } else if (tag == REPLAY_TAG_INPUT) {
+      if (!get_unsigned(file, &count)) {
+        break;
+      }
+      i = 0;
+      while (i < 2 * count && get_unsigned(file, &value)) {
+        i++;
+      }
+      if (i < 2 * count) {
+        break;
+      }
+      scanned++;
+    } else if (tag == REPLAY_TAG_HASH) {
+      if (!get_unsigned(file, &value)) {
+        break;
+      }
+    } else if (tag == REPLAY_TAG_KEYFRAME) {
+      if (!get_unsigned(file, &keyframe_frame) || !get_unsigned(file, &value)) {
+        break;
+      }
+      if (keyframe_frame <= frame) {
+        keyframe = position;
+      }
+      fseek(file, (long)value, SEEK_CUR);
+    } else {
+      break;
+    }
+  }
+  return keyframe;
+}
+
+/**
+ * Brings the game to the start of the provided frame, restoring the last keyframe before it and simulating from there.
+ *
+ * Returns 0 if the replay ends before the frame, or if the frame is before the current one and before all keyframes.
+ */
+int seek_replay(ReplayReader *reader, Game *const game, const unsigned long frame) {
+  const long position = ftell(reader->file);
+  const long keyframe = find_keyframe(reader, frame);
+  unsigned long keyframe_frame = 0;
+  unsigned long length;
+  if (keyframe != -1) {
+    /* find_keyframe already read the frame of the keyframe, so this only fails if the file changed meanwhile. */
+    if (fseek(reader->file, keyframe + 1, SEEK_SET) || !get_unsigned(reader->file, &keyframe_frame)) {
+      fseek(reader->file, position, SEEK_SET);
+      return 0;
+    }
+  }
+  if (keyframe != -1 && (keyframe_frame > reader->frame || frame < reader->frame)) {
+    /* A damaged keyframe leaves the game untouched, so the replay can go on from where it was. */
+    if (!get_unsigned(reader->file, &length) || !get_keyframe(reader->file, game, keyframe_frame)) {
+      fseek(reader->file, position, SEEK_SET);
+      return 0;
+    }
+    reader->frame = keyframe_frame;
+    reader->idle = 0;
+  } else if (frame < reader->frame) {
+    fseek(reader->file, position, SEEK_SET);
+    return 0;
+  } else {
+    fseek(reader->file, position, SEEK_SET);
+  }
+  while (reader->frame < frame) {
+    if (!replay_game_step(reader, game)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/**
+ * Returns whether the game ever differed from a hash in the replay, writing the first frame at which it did.
+ */
+int get_replay_divergence(const ReplayReader *reader, unsigned long *frame) {
+  if (reader->diverged) {
+    *frame = reader->divergence;
+  }
+  return reader->diverged;
+}
+
+/**
+ * Simulates a whole replay as fast as possible, comparing the game with the hashes of the recorded game.
+ *
+ * The first frame at which the games differed is written to frame, and otherwise how many frames were simulated.
+ */
+ReplayVerdict verify_replay(const char *filename, unsigned long *frame) {
+  char name[MAXIMUM_PLAYER_NAME_SIZE] = "Verifier";
+  ReplayVerdict verdict = REPLAY_IDENTICAL;
+  ReplayReader *reader;
+  CommandTable table;
+  Player player;
+  Engine engine;
+  Game game;
+  initialize_engine(&engine, create_random_state(0));
+  reader = create_replay_reader(filename, &engine);
+  if (reader == NULL) {
+    return REPLAY_UNREADABLE;
+  }
+  initialize_command_table(&table);
+  player = create_player(name, &table);
+  game = create_game(&player, &engine);
+  while (!reader->diverged && replay_game_step(reader, &game)) {
+  }
+  *frame = game.frame;
+  if (get_replay_divergence(reader, frame)) {
+    verdict = REPLAY_DIVERGED;
+  } else if (!reader->hashed) {
+    verdict = REPLAY_WITHOUT_HASHES;
+  }
+  destroy_game(&game);
+  destroy_replay_reader(reader);
+  return verdict;
+}
@@ -0,0 +1,92 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "game.h"
+
+/**
+ * Replays record everything needed to simulate a game again exactly as it was played.
+ *
+ * A replay starts with the settings which change the simulation and the state of the PRNG before the game was
+ * created. After that come the changes the player made to the command table in each frame, with runs of frames without
+ * changes stored as a single count. Every few seconds of game a keyframe saves the whole state of the simulation, so
+ * that seeking does not require simulating from the first frame.
+ *
+ * If the state hash period is not zero, a hash of the state follows every frame which is a multiple of it, so that
+ * playing the replay can check that the game is simulated exactly like when it was recorded.
+ *
+ * All numbers are stored as variable-length integers, so frames without input cost almost nothing.
+ */
+
+#define REPLAY_FILE "replay.bin"
+
+/* How many seconds of game pass between keyframes. */
+#define REPLAY_KEYFRAME_PERIOD 10
+
+typedef struct ReplayWriter ReplayWriter;
+
+typedef struct ReplayReader ReplayReader;
+
+typedef enum ReplayVerdict {
+  REPLAY_IDENTICAL,
+  REPLAY_DIVERGED,
+  REPLAY_WITHOUT_HASHES,
+  REPLAY_UNREADABLE
+} ReplayVerdict;
+
+/**
+ * Starts recording a replay to the file, saving the settings and the state of the PRNG of the engine.
+ *
+ * This should be called right before the game is created with the engine, as creating it already uses the PRNG.
+ *
+ * Returns NULL if the file could not be opened.
+ */
+ReplayWriter *create_replay_writer(const char *filename, const Engine *const engine);
+
+/**
+ * Finishes the replay and closes its file.
+ */
+ReplayWriter *destroy_replay_writer(ReplayWriter *writer);
+
+/**
+ * Records the changes to the command table of the player since the last frame and simulates a frame.
+ */
+void record_game_step(ReplayWriter *writer, Game *const game);
+
+/**
+ * Opens a replay, restoring the settings it was recorded with and the state of the PRNG of the engine.
+ *
+ * The game should be created with the engine right after this, so that it starts exactly like the recorded game.
+ *
+ * Returns NULL if the file could not be opened or is not a replay.
+ */
+ReplayReader *create_replay_reader(const char *filename, Engine *engine);
+
+ReplayReader *destroy_replay_reader(ReplayReader *reader);
+
+/**
+ * Simulates the next frame of the replay, returning 0 if the replay has ended.
+ */
+int replay_game_step(ReplayReader *reader, Game *const game);
+
+/**
+ * Brings the game to the start of the provided frame, restoring the last keyframe before it and simulating from there.
+ *
+ * Returns 0 if the replay ends before the frame, or if the frame is before the current one and before all keyframes.
+ */
+int seek_replay(ReplayReader *reader, Game *const game, const unsigned long frame);
+
+/**
+ * Returns whether the game ever differed from a hash in the replay, writing the first frame at which it did.
+ *
+ * The frame is the one the game was at right after simulating the frame that made it differ.
+ */
+int get_replay_divergence(const ReplayReader *reader, unsigned long *frame);
+
+/**
+ * Simulates a whole replay as fast as possible, comparing the game with the hashes of the recorded game.
+ *
+ * The first frame at which the games differed is written to frame, and otherwise how many frames were simulated.
+ */
+ReplayVerdict verify_replay(const char *filename, unsigned long *frame);
+
+#endif
@@ -39,6 +39,10 @@ static const long MINIMUM_DIMENSION = 240;
 static int width = -1;
 static int height = -1;
 
+/* Zero means that the logical dimension is the same as the window dimension. */
+static int logical_width = 0;
+static int logical_height = 0;
+
 static const long MAXIMUM_TILE_DIMENSION = 16384;
 static const long MINIMUM_TILE_DIMENSION = 1;
 
@@ -76,6 +80,8 @@ static double investment_minimum_factor = 0.75;
 
 static RendererType renderer_type = RENDERER_HARDWARE;
 
+static CollisionBackend collision_backend = COLLISION_BACKEND_DENSE;
+
 static int platform_max_width = 16;
 static int platform_min_width = 4;
 
@@ -84,6 +90,27 @@ static int platform_min_speed = 1;
 
 static int logging_player_score = 0;
 
+static int logging_state_hash = 0;
+
+static const long MAXIMUM_STATE_HASH_PERIOD = 65536;
+static const long MINIMUM_STATE_HASH_PERIOD = -1;
+/* In frames, where 0 means once per second at any tick rate and -1 means never. */
+static int state_hash_period = 0;
+
+static const long MAXIMUM_PLATFORM_THREADS = 64;
+static const long MINIMUM_PLATFORM_THREADS = 1;
+static int platform_threads = 1;
+
+static const long MAXIMUM_TICK_RATE = 1000;
+static const long MINIMUM_TICK_RATE = 30;
+static int tick_rate = 200;
+
+static const long MAXIMUM_RENDER_RATE = 1000;
+static const long MINIMUM_RENDER_RATE = 1;
+static int render_rate = 60;
+
+static int vsync = 0;
+
 static int is_word_part(char character) { return !isspace(character) && character != '='; }
 
 static void skip_to_word(const char **input) {
@@ -203,23 +230,26 @@ static void log_unused_key(const char *key) {
 }
 
 static void validate_settings(void) {
-  if ((get_window_width() % get_tile_height()) != 0) {
+  if ((get_logical_width() % get_tile_height()) != 0) {
     exit(EXIT_FAILURE);
   }
-  if (((get_window_height() - 2 * get_bar_height()) % get_tile_height()) != 0) {
+  if (((get_logical_height() - 2 * get_bar_height()) % get_tile_height()) != 0) {
     exit(EXIT_FAILURE);
   }
 }
 
-void initialize_settings(void) {
-  char input[SETTINGS_BUFFER_SIZE];
+/**
+ * Changes the settings to the values in the input, which should be in the format of the settings file.
+ *
+ * Settings which are not in the input are left unchanged.
+ */
+void parse_settings(const char *input) {
   char key[SETTINGS_STRING_SIZE];
   char value[SETTINGS_STRING_SIZE];
   const char *read = input;
   struct Limits limits;
   struct DoubleLimits double_limits;
   int i;
-  read_characters(SETTINGS_FILE, input, SETTINGS_BUFFER_SIZE);
   while (parse_line(&read, key, value)) {
     if (string_equals(key, "REPOSITION_ALGORITHM")) {
       if (string_equals(value, "REPOSITION_SELECT_BLINDLY")) {
@@ -250,6 +280,16 @@ void initialize_settings(void) {
       limits.maximum = MAXIMUM_DIMENSION;
       limits.fallback = height;
       height = parse_integer(value, limits);
+    } else if (string_equals(key, "LOGICAL_WIDTH")) {
+      limits.minimum = MINIMUM_DIMENSION;
+      limits.maximum = MAXIMUM_DIMENSION;
+      limits.fallback = logical_width;
+      logical_width = parse_integer(value, limits);
+    } else if (string_equals(key, "LOGICAL_HEIGHT")) {
+      limits.minimum = MINIMUM_DIMENSION;
+      limits.maximum = MAXIMUM_DIMENSION;
+      limits.fallback = logical_height;
+      logical_height = parse_integer(value, limits);
     } else if (string_equals(key, "TILE_WIDTH")) {
       limits.minimum = MINIMUM_TILE_DIMENSION;
       limits.maximum = MAXIMUM_TILE_DIMENSION;
@@ -283,6 +323,14 @@ void initialize_settings(void) {
     } else if (string_equals(key, "LOGGING_PLAYER_SCORE")) {
       limits.fallback = logging_player_score;
       logging_player_score = parse_boolean(value, limits.fallback);
+    } else if (string_equals(key, "LOGGING_STATE_HASH")) {
+      limits.fallback = logging_state_hash;
+      logging_state_hash = parse_boolean(value, limits.fallback);
+    } else if (string_equals(key, "STATE_HASH_PERIOD")) {
+      limits.minimum = MINIMUM_STATE_HASH_PERIOD;
+      limits.maximum = MAXIMUM_STATE_HASH_PERIOD;
+      limits.fallback = state_hash_period;
+      state_hash_period = parse_integer(value, limits);
     } else if (string_equals(key, "JOYSTICK_PROFILE")) {
       if (string_equals(value, "XBOX")) {
         joystick_profile = JOYSTICK_PROFILE_XBOX;
@@ -346,6 +394,33 @@ void initialize_settings(void) {
       } else {
         renderer_type = RENDERER_SOFTWARE;
       }
+    } else if (string_equals(key, "COLLISION_BACKEND")) {
+      if (string_equals(value, "DENSE")) {
+        collision_backend = COLLISION_BACKEND_DENSE;
+      } else if (string_equals(value, "PACKED")) {
+        collision_backend = COLLISION_BACKEND_PACKED;
+      } else if (string_equals(value, "SPANS")) {
+        collision_backend = COLLISION_BACKEND_SPANS;
+      } else if (string_equals(value, "CHUNKED")) {
+        collision_backend = COLLISION_BACKEND_CHUNKED;
+      }
+    } else if (string_equals(key, "PLATFORM_THREADS")) {
+      limits.minimum = MINIMUM_PLATFORM_THREADS;
+      limits.maximum = MAXIMUM_PLATFORM_THREADS;
+      limits.fallback = platform_threads;
+      platform_threads = parse_integer(value, limits);
+    } else if (string_equals(key, "TICK_RATE")) {
+      limits.minimum = MINIMUM_TICK_RATE;
+      limits.maximum = MAXIMUM_TICK_RATE;
+      limits.fallback = tick_rate;
+      tick_rate = parse_integer(value, limits);
+    } else if (string_equals(key, "RENDER_RATE")) {
+      limits.minimum = MINIMUM_RENDER_RATE;
+      limits.maximum = MAXIMUM_RENDER_RATE;
+      limits.fallback = render_rate;
+      render_rate = parse_integer(value, limits);
+    } else if (string_equals(key, "VSYNC")) {
+      vsync = parse_boolean(value, vsync);
     } else {
       log_unused_key(key);
     }
@@ -353,10 +428,73 @@ void initialize_settings(void) {
   validate_settings();
 }
 
+void initialize_settings(void) {
+  char input[SETTINGS_BUFFER_SIZE];
+  read_characters(SETTINGS_FILE, input, SETTINGS_BUFFER_SIZE);
+  parse_settings(input);
+}
+
+/**
+ * Appends a line to the buffer if it fits, returning 0 if it does not.
+ */
+static int append_line(char *buffer, const size_t size, const char *line) {
+  const size_t used = strlen(buffer);
+  const size_t length = strlen(line);
+  if (used + length + 1 > size) {
+    return 0;
+  }
+  memcpy(buffer + used, line, length + 1);
+  return 1;
+}
+
+/**
+ * Writes the settings which change how the game is simulated to the buffer, in the format of the settings file.
+ *
+ * Returns 0 if the buffer is too small, in which case it holds only some of the settings.
+ */
+int write_simulation_settings(char *buffer, const size_t size) {
+  char line[SETTINGS_STRING_SIZE];
+  int fits = 1;
+  buffer[0] = '\0';
+  if (reposition_algorithm == REPOSITION_SELECT_BLINDLY) {
+    sprintf(line, "REPOSITION_ALGORITHM = REPOSITION_SELECT_BLINDLY\n");
+  } else {
+    sprintf(line, "REPOSITION_ALGORITHM = REPOSITION_SELECT_AWARELY\n");
+  }
+  fits = fits && append_line(buffer, size, line);
+  sprintf(line, "PLATFORM_COUNT = %ld\n", platform_count);
+  fits = fits && append_line(buffer, size, line);
+  sprintf(line, "LOGICAL_WIDTH = %d\nLOGICAL_HEIGHT = %d\n", get_logical_width(), get_logical_height());
+  fits = fits && append_line(buffer, size, line);
+  sprintf(line, "TILE_WIDTH = %d\nTILE_HEIGHT = %d\nBAR_HEIGHT = %d\n", tile_width, tile_height, bar_height);
+  fits = fits && append_line(buffer, size, line);
+  sprintf(line, "PLAYER_STOPS_PLATFORMS = %d\n", player_stops_platforms);
+  fits = fits && append_line(buffer, size, line);
+  sprintf(line, "INVESTMENT_MODE = %s\n", get_investment_mode_name(investment_mode));
+  fits = fits && append_line(buffer, size, line);
+  sprintf(line, "INVESTMENT_AMOUNT = %ld\nINVESTMENT_PERIOD = %ld\n", investment_amount, investment_period);
+  fits = fits && append_line(buffer, size, line);
+  sprintf(line, "INVESTMENT_PROPORTION = %.17g\n", investment_proportion);
+  fits = fits && append_line(buffer, size, line);
+  sprintf(line, "INVESTMENT_MAXIMUM_FACTOR = %.17g\n", investment_maximum_factor);
+  fits = fits && append_line(buffer, size, line);
+  sprintf(line, "INVESTMENT_MINIMUM_FACTOR = %.17g\n", investment_minimum_factor);
+  fits = fits && append_line(buffer, size, line);
+  sprintf(line, "PLATFORM_MAXIMUM_WIDTH = %d\nPLATFORM_MINIMUM_WIDTH = %d\n", platform_max_width, platform_min_width);
+  fits = fits && append_line(buffer, size, line);
+  sprintf(line, "PLATFORM_MAXIMUM_SPEED = %d\nPLATFORM_MINIMUM_SPEED = %d\n", platform_max_speed, platform_min_speed);
+  fits = fits && append_line(buffer, size, line);
+  sprintf(line, "TICK_RATE = %d\n", tick_rate);
+  fits = fits && append_line(buffer, size, line);
+  return fits;
+}
+
 RepositionAlgorithm get_reposition_algorithm(void) { return reposition_algorithm; }
 
 RendererType get_renderer_type(void) { return renderer_type; }
 
+CollisionBackend get_collision_backend(void) { return collision_backend; }
+
 long get_platform_count(void) { return platform_count; }
 
 int get_font_size(void) { return font_size; }
@@ -371,6 +509,12 @@ int get_window_width(void) { return width; }
 
 int get_window_height(void) { return height; }
 
+int get_logical_width(void) { return logical_width ? logical_width : width; }
+
+int get_logical_height(void) { return logical_height ? logical_height : height; }
+
+int is_logical_size_scaled(void) { return get_logical_width() != width || get_logical_height() != height; }
+
 long get_padding(void) { return padding; }
 
 int get_player_stops_platforms(void) { return player_stops_platforms; }
@@ -398,3 +542,21 @@ int get_platform_max_speed(void) { return platform_max_speed; }
 int get_platform_min_speed(void) { return platform_min_speed; }
 
 int is_logging_player_score(void) { return logging_player_score; }
+
+int is_logging_state_hash(void) { return logging_state_hash; }
+
+int get_state_hash_period(void) {
+  if (state_hash_period == 0) {
+    /* Once per second, so that hashing does not slow the game down or break up idle runs at any tick rate. */
+    return tick_rate;
+  }
+  return state_hash_period < 0 ? 0 : state_hash_period;
+}
+
+int get_platform_threads(void) { return platform_threads; }
+
+int get_tick_rate(void) { return tick_rate; }
+
+int get_render_rate(void) { return render_rate; }
+
+int is_vsync_enabled(void) { return vsync; }
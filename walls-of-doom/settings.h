@@ -2,10 +2,11 @@
 #define SETTINGS_H
 
 #include "investment.h"
+#include <stdlib.h>
 
 /* These maximums are made public so that static allocation is possible. */
 
-#define MAXIMUM_PLATFORM_COUNT 256
+#define MAXIMUM_PLATFORM_COUNT 65536
 
 #define JOYSTICK_PROFILE_XBOX 1
 #define JOYSTICK_PROFILE_DUALSHOCK 2
@@ -14,8 +15,29 @@ typedef enum RepositionAlgorithm { REPOSITION_SELECT_BLINDLY, REPOSITION_SELECT_
 
 typedef enum RendererType { RENDERER_HARDWARE, RENDERER_SOFTWARE } RendererType;
 
+typedef enum CollisionBackend {
+  COLLISION_BACKEND_DENSE,
+  COLLISION_BACKEND_PACKED,
+  COLLISION_BACKEND_SPANS,
+  COLLISION_BACKEND_CHUNKED
+} CollisionBackend;
+
 void initialize_settings(void);
 
+/**
+ * Changes the settings to the values in the input, which should be in the format of the settings file.
+ *
+ * Settings which are not in the input are left unchanged.
+ */
+void parse_settings(const char *input);
+
+/**
+ * Writes the settings which change how the game is simulated to the buffer, in the format of the settings file.
+ *
+ * Returns 0 if the buffer is too small, in which case it holds only some of the settings.
+ */
+int write_simulation_settings(char *buffer, const size_t size);
+
 RepositionAlgorithm get_reposition_algorithm(void);
 
 long get_platform_count(void);
@@ -26,6 +48,25 @@ int get_window_width(void);
 
 int get_window_height(void);
 
+/**
+ * Returns the width the game is simulated and drawn at, which is scaled to the window width.
+ *
+ * Unless LOGICAL_WIDTH is set, this is the window width.
+ */
+int get_logical_width(void);
+
+/**
+ * Returns the height the game is simulated and drawn at, which is scaled to the window height.
+ *
+ * Unless LOGICAL_HEIGHT is set, this is the window height.
+ */
+int get_logical_height(void);
+
+/**
+ * Evaluates whether or not the logical size differs from the window size, so drawing must be scaled.
+ */
+int is_logical_size_scaled(void);
+
 int get_tile_width(void);
 
 int get_tile_height(void);
@@ -52,6 +93,8 @@ double get_investment_minimum_factor(void);
 
 RendererType get_renderer_type(void);
 
+CollisionBackend get_collision_backend(void);
+
 int get_platform_max_width(void);
 
 int get_platform_min_width(void);
@@ -62,4 +105,32 @@ int get_platform_min_speed(void);
 
 int is_logging_player_score(void);
 
+int is_logging_state_hash(void);
+
+/**
+ * Returns how many frames pass between hashes of the state of the simulation, or 0 if the state is not hashed.
+ *
+ * Unless the settings set a period, this is the tick rate, so that the state is hashed once per second.
+ */
+int get_state_hash_period(void);
+
+int get_platform_threads(void);
+
+/**
+ * Returns how many frames the game simulates per second.
+ *
+ * All durations in frames are derived from this, so gameplay timings are the same at any tick rate.
+ */
+int get_tick_rate(void);
+
+/**
+ * Returns at most how many times per second the game is drawn, independently of the tick rate.
+ */
+int get_render_rate(void);
+
+/**
+ * Evaluates whether or not presenting a drawing waits for the vertical retrace of the display.
+ */
+int is_vsync_enabled(void);
+
 #endif
@@ -0,0 +1,285 @@
+#include "span-table.h"
+#include "memory.h"
+#include "numeric.h"
+#include <string.h>
+
+#define INITIAL_SPAN_CAPACITY 4
+
+SpanTable *create_span_table(const int width, const int height, const int row_height) {
+  SpanTable *table = resize_memory(NULL, sizeof(SpanTable));
+  int i;
+  table->width = width;
+  table->height = height;
+  table->row_height = row_height;
+  table->row_count = (height + row_height - 1) / row_height;
+  table->rows = resize_memory(NULL, sizeof(SpanRow) * max_int(1, table->row_count));
+  for (i = 0; i < table->row_count; i++) {
+    table->rows[i].spans = NULL;
+    table->rows[i].span_count = 0;
+    table->rows[i].span_capacity = 0;
+  }
+  return table;
+}
+
+SpanTable *destroy_span_table(SpanTable *table) {
+  int i;
+  if (table != NULL) {
+    for (i = 0; i < table->row_count; i++) {
+      table->rows[i].spans = resize_memory(table->rows[i].spans, 0);
+    }
+    table->rows = resize_memory(table->rows, 0);
+  }
+  return resize_memory(table, 0);
+}
+
+/**
+ * Clips the rectangle to the table, returning 0 if nothing is left of it.
+ */
+static int clip_rectangle(const SpanTable *const table, int *x, int *y, int *w, int *h) {
+  if (*x < 0) {
+    *w += *x;
+    *x = 0;
+  }
+  if (*y < 0) {
+    *h += *y;
+    *y = 0;
+  }
+  if (*x + *w > table->width) {
+    *w = table->width - *x;
+  }
+  if (*y + *h > table->height) {
+    *h = table->height - *y;
+  }
+  return *w > 0 && *h > 0;
+}
+
+static void insert_span(SpanRow *row, const int min_x, const int max_x) {
+  size_t i;
+  if (row->span_count == row->span_capacity) {
+    row->span_capacity = row->span_capacity ? 2 * row->span_capacity : INITIAL_SPAN_CAPACITY;
+    row->spans = resize_memory(row->spans, sizeof(Span) * row->span_capacity);
+  }
+  /* Insertion sort step, as rows usually have very few spans. */
+  i = row->span_count;
+  while (i > 0 && row->spans[i - 1].min_x > min_x) {
+    row->spans[i] = row->spans[i - 1];
+    i--;
+  }
+  row->spans[i].min_x = min_x;
+  row->spans[i].max_x = max_x;
+  row->span_count++;
+}
+
+static void delete_span(SpanRow *row, const size_t i) {
+  row->span_count--;
+  memmove(row->spans + i, row->spans + i + 1, sizeof(Span) * (row->span_count - i));
+}
+
+/**
+ * Moves the span at index i to its sorted position after its min_x changed.
+ */
+static void resort_span(SpanRow *row, size_t i) {
+  Span swap;
+  while (i > 0 && row->spans[i - 1].min_x > row->spans[i].min_x) {
+    swap = row->spans[i - 1];
+    row->spans[i - 1] = row->spans[i];
+    row->spans[i] = swap;
+    i--;
+  }
+  while (i + 1 < row->span_count && row->spans[i + 1].min_x < row->spans[i].min_x) {
+    swap = row->spans[i + 1];
+    row->spans[i + 1] = row->spans[i];
+    row->spans[i] = swap;
+    i++;
+  }
+}
+
+static void add_to_row(SpanRow *row, const int min_x, const int max_x) {
+  size_t i;
+  /* Extend an adjacent span instead of fragmenting the row. */
+  for (i = 0; i < row->span_count; i++) {
+    if (row->spans[i].max_x == min_x) {
+      row->spans[i].max_x = max_x;
+      return;
+    }
+  }
+  for (i = 0; i < row->span_count; i++) {
+    if (row->spans[i].min_x == max_x) {
+      row->spans[i].min_x = min_x;
+      resort_span(row, i);
+      return;
+    }
+  }
+  insert_span(row, min_x, max_x);
+}
+
+/**
+ * Returns the index of a span covering x, preferring one which starts at x.
+ *
+ * Returns the span count if no span covers x.
+ */
+static size_t find_covering_span(const SpanRow *const row, const int x) {
+  size_t found = row->span_count;
+  size_t i;
+  for (i = 0; i < row->span_count && row->spans[i].min_x <= x; i++) {
+    if (row->spans[i].max_x > x) {
+      if (row->spans[i].min_x == x) {
+        return i;
+      }
+      found = i;
+    }
+  }
+  return found;
+}
+
+static void remove_from_row(SpanRow *row, const int min_x, const int max_x) {
+  int position = min_x;
+  Span span;
+  size_t i;
+  int cut;
+  /* The removed coverage may be split among several spans, so cut it piece by piece. */
+  while (position < max_x) {
+    i = find_covering_span(row, position);
+    if (i == row->span_count) {
+      /* Nothing covers this position, so there is nothing left to remove. */
+      return;
+    }
+    span = row->spans[i];
+    cut = min_int(span.max_x, max_x);
+    if (span.min_x == position) {
+      if (cut == span.max_x) {
+        delete_span(row, i);
+      } else {
+        row->spans[i].min_x = cut;
+        resort_span(row, i);
+      }
+    } else {
+      row->spans[i].max_x = position;
+      if (cut < span.max_x) {
+        insert_span(row, cut, span.max_x);
+      }
+    }
+    position = cut;
+  }
+}
+
+static int is_row_free(const SpanRow *const row, const int min_x, const int max_x) {
+  size_t i;
+  for (i = 0; i < row->span_count && row->spans[i].min_x < max_x; i++) {
+    if (row->spans[i].max_x > min_x) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/**
+ * Returns 1 if the cell at (x, y) is covered by any span and 0 otherwise.
+ */
+int span_table_get(const SpanTable *const table, const int x, const int y) {
+  return !span_table_is_free(table, x, y, 1, 1);
+}
+
+/**
+ * Covers the rectangle once more.
+ */
+void span_table_add(SpanTable *table, int x, int y, int w, int h) {
+  int i;
+  if (!clip_rectangle(table, &x, &y, &w, &h)) {
+    return;
+  }
+  for (i = y / table->row_height; i <= (y + h - 1) / table->row_height; i++) {
+    add_to_row(table->rows + i, x, x + w);
+  }
+}
+
+/**
+ * Removes one layer of coverage from the rectangle, which should have been added before.
+ */
+void span_table_remove(SpanTable *table, int x, int y, int w, int h) {
+  int i;
+  if (!clip_rectangle(table, &x, &y, &w, &h)) {
+    return;
+  }
+  for (i = y / table->row_height; i <= (y + h - 1) / table->row_height; i++) {
+    remove_from_row(table->rows + i, x, x + w);
+  }
+}
+
+/**
+ * Evaluates whether or not no span intersects the rectangle.
+ */
+int span_table_is_free(const SpanTable *const table, int x, int y, int w, int h) {
+  int i;
+  if (!clip_rectangle(table, &x, &y, &w, &h)) {
+    return 1;
+  }
+  for (i = y / table->row_height; i <= (y + h - 1) / table->row_height; i++) {
+    if (!is_row_free(table->rows + i, x, x + w)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/**
+ * Returns the first covered column of the row in [min_x, max_x), or max_x if there is none.
+ */
+static int find_first_in_row(const SpanRow *const row, const int min_x, const int max_x) {
+  size_t i;
+  /* As spans are sorted by min_x, the first one that intersects the range has the first covered column. */
+  for (i = 0; i < row->span_count && row->spans[i].min_x < max_x; i++) {
+    if (row->spans[i].max_x > min_x) {
+      return max_int(row->spans[i].min_x, min_x);
+    }
+  }
+  return max_x;
+}
+
+/**
+ * Returns the last covered column of the row in [min_x, max_x), or min_x - 1 if there is none.
+ */
+static int find_last_in_row(const SpanRow *const row, const int min_x, const int max_x) {
+  int found = min_x - 1;
+  size_t i;
+  for (i = 0; i < row->span_count && row->spans[i].min_x < max_x; i++) {
+    if (row->spans[i].max_x > min_x) {
+      found = max_int(found, min_int(row->spans[i].max_x, max_x) - 1);
+    }
+  }
+  return found;
+}
+
+/**
+ * Returns the leftmost column of the rectangle covered by a span, or x + w if no span intersects it.
+ */
+int span_table_find_first(const SpanTable *const table, int x, int y, int w, int h) {
+  const int none = x + w;
+  int found;
+  int i;
+  if (!clip_rectangle(table, &x, &y, &w, &h)) {
+    return none;
+  }
+  found = x + w;
+  for (i = y / table->row_height; i <= (y + h - 1) / table->row_height && found > x; i++) {
+    found = find_first_in_row(table->rows + i, x, found);
+  }
+  return found == x + w ? none : found;
+}
+
+/**
+ * Returns the rightmost column of the rectangle covered by a span, or x - 1 if no span intersects it.
+ */
+int span_table_find_last(const SpanTable *const table, int x, int y, int w, int h) {
+  const int none = x - 1;
+  int found;
+  int i;
+  if (!clip_rectangle(table, &x, &y, &w, &h)) {
+    return none;
+  }
+  found = x - 1;
+  for (i = y / table->row_height; i <= (y + h - 1) / table->row_height && found < x + w - 1; i++) {
+    found = find_last_in_row(table->rows + i, found + 1, x + w);
+  }
+  return found == x - 1 ? none : found;
+}
@@ -0,0 +1,76 @@
+#ifndef SPAN_TABLE_H
+#define SPAN_TABLE_H
+
+#include <stdlib.h>
+
+/**
+ * A table of occupied horizontal spans, bucketed by rows of a fixed height.
+ *
+ * Each row keeps a list of [min_x, max_x) spans sorted by min_x. Spans may overlap, in which case the cells they share
+ * are covered more than once, just like in a counting matrix. Memory grows with the number of spans rather than with
+ * the area of the table.
+ *
+ * The table only tracks rectangles at row granularity: adding a rectangle covers every row it intersects entirely, so
+ * it is exact only for rectangles aligned to the rows, which is the case for platforms.
+ *
+ * All coordinates are relative to the top left corner of the table. Cells outside of the table are always free and
+ * writes to them are ignored.
+ */
+
+typedef struct Span {
+  int min_x;
+  int max_x;
+} Span;
+
+typedef struct SpanRow {
+  Span *spans;
+  size_t span_count;
+  size_t span_capacity;
+} SpanRow;
+
+typedef struct SpanTable {
+  int width;
+  int height;
+  int row_height;
+  int row_count;
+  SpanRow *rows;
+} SpanTable;
+
+/**
+ * Creates a new empty SpanTable.
+ */
+SpanTable *create_span_table(const int width, const int height, const int row_height);
+
+SpanTable *destroy_span_table(SpanTable *table);
+
+/**
+ * Returns 1 if the cell at (x, y) is covered by any span and 0 otherwise.
+ */
+int span_table_get(const SpanTable *const table, const int x, const int y);
+
+/**
+ * Covers the rectangle once more.
+ */
+void span_table_add(SpanTable *table, int x, int y, int w, int h);
+
+/**
+ * Removes one layer of coverage from the rectangle, which should have been added before.
+ */
+void span_table_remove(SpanTable *table, int x, int y, int w, int h);
+
+/**
+ * Evaluates whether or not no span intersects the rectangle.
+ */
+int span_table_is_free(const SpanTable *const table, int x, int y, int w, int h);
+
+/**
+ * Returns the leftmost column of the rectangle covered by a span, or x + w if no span intersects it.
+ */
+int span_table_find_first(const SpanTable *const table, int x, int y, int w, int h);
+
+/**
+ * Returns the rightmost column of the rectangle covered by a span, or x - 1 if no span intersects it.
+ */
+int span_table_find_last(const SpanTable *const table, int x, int y, int w, int h);
+
+#endif
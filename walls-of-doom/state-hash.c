@@ -0,0 +1,101 @@
+#include "state-hash.h"
+#include "random.h"
+
+#define PRIME_2 2246822519UL
+#define PRIME_3 3266489917UL
+#define PRIME_4 668265263UL
+#define PRIME_5 374761393UL
+
+#define WORD_MASK 0xFFFFFFFFUL
+
+static unsigned long rotate_left(const unsigned long word, const int bits) {
+  return ((word << bits) | (word >> (32 - bits))) & WORD_MASK;
+}
+
+void initialize_hasher(Hasher *hasher) {
+  hasher->accumulator = PRIME_5;
+  hasher->length = 0;
+}
+
+/**
+ * Mixes the lowest 32 bits of the word into the hash.
+ */
+void hasher_add(Hasher *hasher, const unsigned long word) {
+  hasher->accumulator = (hasher->accumulator + (word & WORD_MASK) * PRIME_3) & WORD_MASK;
+  hasher->accumulator = (rotate_left(hasher->accumulator, 17) * PRIME_4) & WORD_MASK;
+  hasher->length++;
+}
+
+/**
+ * Mixes all bits of the value into the hash, including the bits above the lowest 32 where long has them.
+ */
+void hasher_add_long(Hasher *hasher, const unsigned long value) {
+  hasher_add(hasher, value);
+  /* Shifting twice is defined even where long only has 32 bits. */
+  hasher_add(hasher, (value >> 16) >> 16);
+}
+
+/**
+ * Returns the hash of all words mixed in so far.
+ */
+StateHash finish_hasher(const Hasher *hasher) {
+  unsigned long hash = (hasher->accumulator + 4 * hasher->length) & WORD_MASK;
+  hash ^= hash >> 15;
+  hash = (hash * PRIME_2) & WORD_MASK;
+  hash ^= hash >> 13;
+  hash = (hash * PRIME_3) & WORD_MASK;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+static void hash_player(Hasher *hasher, const Player *const player) {
+  const Investment *investment;
+  hasher_add_long(hasher, player->x);
+  hasher_add_long(hasher, player->y);
+  hasher_add_long(hasher, player->speed_x);
+  hasher_add_long(hasher, player->speed_y);
+  hasher_add_long(hasher, player->remainder_x);
+  hasher_add_long(hasher, player->physics);
+  hasher_add_long(hasher, player->can_double_jump);
+  hasher_add_long(hasher, player->remaining_jump_height);
+  hasher_add_long(hasher, player->lives);
+  hasher_add_long(hasher, player->score);
+  hasher_add_long(hasher, player->perk);
+  hasher_add(hasher, player->perk_end_frame);
+  for (investment = player->investments; investment != NULL; investment = investment->next) {
+    hasher_add(hasher, investment->end);
+    hasher_add_long(hasher, investment->amount);
+  }
+}
+
+/**
+ * Hashes everything the next frames of the game depend on, except for the input of the player.
+ *
+ * The platform store, the index and the collision backends are derived from the platforms, so they are left out.
+ */
+StateHash hash_game_state(const Game *const game) {
+  const RandomState random_state = game->engine->random;
+  const Platform *platform;
+  Hasher hasher;
+  initialize_hasher(&hasher);
+  hasher_add(&hasher, game->frame);
+  hasher_add(&hasher, game->played_frames);
+  hasher_add(&hasher, game->next_played_frames_score);
+  hasher_add_long(&hasher, random_state.x);
+  hasher_add_long(&hasher, random_state.y);
+  hasher_add_long(&hasher, random_state.z);
+  hasher_add_long(&hasher, random_state.w);
+  hasher_add_long(&hasher, game->perk);
+  hasher_add_long(&hasher, game->perk_x);
+  hasher_add_long(&hasher, game->perk_y);
+  hasher_add(&hasher, game->perk_end_frame);
+  hash_player(&hasher, game->player);
+  for (platform = game->platforms; platform != game->platforms + game->platform_count; platform++) {
+    hasher_add_long(&hasher, platform->x);
+    hasher_add_long(&hasher, platform->y);
+    hasher_add_long(&hasher, platform->w);
+    hasher_add_long(&hasher, platform->h);
+    hasher_add_long(&hasher, platform->speed);
+  }
+  return finish_hasher(&hasher);
+}
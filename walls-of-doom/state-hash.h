@@ -0,0 +1,44 @@
+#ifndef STATE_HASH_H
+#define STATE_HASH_H
+
+#include "game.h"
+
+/**
+ * Hashes of the state of the simulation, to check that two simulations did exactly the same.
+ *
+ * Values are mixed in one 32-bit word at a time like xxHash32 mixes the words at the end of its input, which is a few
+ * multiplications and a rotation per word.
+ */
+
+typedef unsigned long StateHash;
+
+typedef struct Hasher {
+  unsigned long accumulator;
+  unsigned long length;
+} Hasher;
+
+void initialize_hasher(Hasher *hasher);
+
+/**
+ * Mixes the lowest 32 bits of the word into the hash.
+ */
+void hasher_add(Hasher *hasher, const unsigned long word);
+
+/**
+ * Mixes all bits of the value into the hash, including the bits above the lowest 32 where long has them.
+ *
+ * Signed values are converted to unsigned long, which keeps all of their bits.
+ */
+void hasher_add_long(Hasher *hasher, const unsigned long value);
+
+/**
+ * Returns the hash of all words mixed in so far.
+ */
+StateHash finish_hasher(const Hasher *hasher);
+
+/**
+ * Hashes everything the next frames of the game depend on, except for the input of the player.
+ */
+StateHash hash_game_state(const Game *const game);
+
+#endif
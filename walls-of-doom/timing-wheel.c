@@ -0,0 +1,69 @@
+#include "timing-wheel.h"
+#include "memory.h"
+#include "sort.h"
+
+TimingWheel *create_timing_wheel(const size_t slot_count, const size_t item_count) {
+  TimingWheel *wheel = resize_memory(NULL, sizeof(TimingWheel));
+  wheel->slot_count = slot_count;
+  wheel->item_count = item_count;
+  wheel->heads = resize_memory(NULL, sizeof(size_t) * slot_count);
+  wheel->next = resize_memory(NULL, sizeof(size_t) * (item_count ? item_count : 1));
+  wheel->due = resize_memory(NULL, sizeof(size_t) * (item_count ? item_count : 1));
+  timing_wheel_reset(wheel, 0);
+  return wheel;
+}
+
+TimingWheel *destroy_timing_wheel(TimingWheel *wheel) {
+  if (wheel != NULL) {
+    wheel->heads = resize_memory(wheel->heads, 0);
+    wheel->next = resize_memory(wheel->next, 0);
+    wheel->due = resize_memory(wheel->due, 0);
+  }
+  return resize_memory(wheel, 0);
+}
+
+/**
+ * Unschedules all items and moves the wheel to the provided frame.
+ */
+void timing_wheel_reset(TimingWheel *wheel, const unsigned long frame) {
+  size_t i;
+  for (i = 0; i < wheel->slot_count; i++) {
+    wheel->heads[i] = TIMING_WHEEL_NONE;
+  }
+  wheel->frame = frame;
+  wheel->due_count = 0;
+}
+
+/**
+ * Schedules the item for the provided frame, which must be less than slot_count frames after the current frame.
+ */
+void timing_wheel_schedule(TimingWheel *wheel, const size_t item, const unsigned long frame) {
+  size_t *head = wheel->heads + frame % wheel->slot_count;
+  wheel->next[item] = *head;
+  *head = item;
+}
+
+static int compare_items(const void *a, const void *b) {
+  const size_t x = *(const size_t *)a;
+  const size_t y = *(const size_t *)b;
+  return (x > y) - (x < y);
+}
+
+/**
+ * Takes the items scheduled for the current frame into due and advances the wheel to the next frame.
+ *
+ * Returns how many items were taken.
+ */
+size_t timing_wheel_take(TimingWheel *wheel) {
+  size_t *head = wheel->heads + wheel->frame % wheel->slot_count;
+  size_t item;
+  wheel->due_count = 0;
+  for (item = *head; item != TIMING_WHEEL_NONE; item = wheel->next[item]) {
+    wheel->due[wheel->due_count++] = item;
+  }
+  *head = TIMING_WHEEL_NONE;
+  /* Scheduling pushes items to the front of the slot, so they have to be sorted. */
+  sort(wheel->due, wheel->due_count, sizeof(size_t), compare_items);
+  wheel->frame++;
+  return wheel->due_count;
+}
@@ -0,0 +1,54 @@
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include <stdlib.h>
+
+/**
+ * A timing wheel of items scheduled for future frames.
+ *
+ * The wheel has one slot for each of the next slot_count frames. Items are referred to by their index, each item may
+ * be scheduled at most once at a time, and each slot keeps an intrusive singly linked list of its items, so scheduling
+ * never allocates memory.
+ */
+
+#define TIMING_WHEEL_NONE ((size_t)-1)
+
+typedef struct TimingWheel {
+  size_t slot_count;
+  size_t item_count;
+  /* The frame whose slot is taken next. */
+  unsigned long frame;
+  /* The first item of each slot. */
+  size_t *heads;
+  /* The next item in the same slot as each item. */
+  size_t *next;
+  /* The items taken by the last call to timing_wheel_take, in increasing order. */
+  size_t *due;
+  size_t due_count;
+} TimingWheel;
+
+/**
+ * Creates a new empty TimingWheel at frame 0.
+ */
+TimingWheel *create_timing_wheel(const size_t slot_count, const size_t item_count);
+
+TimingWheel *destroy_timing_wheel(TimingWheel *wheel);
+
+/**
+ * Unschedules all items and moves the wheel to the provided frame.
+ */
+void timing_wheel_reset(TimingWheel *wheel, const unsigned long frame);
+
+/**
+ * Schedules the item for the provided frame, which must be less than slot_count frames after the current frame.
+ */
+void timing_wheel_schedule(TimingWheel *wheel, const size_t item, const unsigned long frame);
+
+/**
+ * Takes the items scheduled for the current frame into due and advances the wheel to the next frame.
+ *
+ * Returns how many items were taken.
+ */
+size_t timing_wheel_take(TimingWheel *wheel);
+
+#endif
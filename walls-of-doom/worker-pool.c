@@ -0,0 +1,210 @@
+#include "worker-pool.h"
+#include "logger.h"
+#include "memory.h"
+
+#ifdef _WIN32
+#include <windows.h>
+typedef HANDLE Thread;
+typedef CRITICAL_SECTION Mutex;
+typedef CONDITION_VARIABLE Condition;
+#else
+#include <pthread.h>
+typedef pthread_t Thread;
+typedef pthread_mutex_t Mutex;
+typedef pthread_cond_t Condition;
+#endif
+
+struct WorkerPool {
+  size_t worker_count;
+  Thread *workers;
+  Mutex mutex;
+  /* Signaled when a batch starts or the pool stops. */
+  Condition started;
+  /* Signaled when the last worker is done with a batch. */
+  Condition finished;
+  /* Incremented for every batch, so that workers can tell a new batch from a spurious wakeup. */
+  unsigned long batch;
+  int stopping;
+  WorkerJob job;
+  void *context;
+  size_t job_count;
+  size_t next_job;
+  /* How many workers have not finished the current batch yet. */
+  size_t busy_workers;
+};
+
+#ifdef _WIN32
+
+static void lock(Mutex *mutex) { EnterCriticalSection(mutex); }
+
+static void unlock(Mutex *mutex) { LeaveCriticalSection(mutex); }
+
+static void wait_for(Condition *condition, Mutex *mutex) { SleepConditionVariableCS(condition, mutex, INFINITE); }
+
+static void signal_all(Condition *condition) { WakeAllConditionVariable(condition); }
+
+static void initialize_synchronization(WorkerPool *pool) {
+  InitializeCriticalSection(&pool->mutex);
+  InitializeConditionVariable(&pool->started);
+  InitializeConditionVariable(&pool->finished);
+}
+
+static void finalize_synchronization(WorkerPool *pool) { DeleteCriticalSection(&pool->mutex); }
+
+#else
+
+static void lock(Mutex *mutex) { pthread_mutex_lock(mutex); }
+
+static void unlock(Mutex *mutex) { pthread_mutex_unlock(mutex); }
+
+static void wait_for(Condition *condition, Mutex *mutex) { pthread_cond_wait(condition, mutex); }
+
+static void signal_all(Condition *condition) { pthread_cond_broadcast(condition); }
+
+static void initialize_synchronization(WorkerPool *pool) {
+  pthread_mutex_init(&pool->mutex, NULL);
+  pthread_cond_init(&pool->started, NULL);
+  pthread_cond_init(&pool->finished, NULL);
+}
+
+static void finalize_synchronization(WorkerPool *pool) {
+  pthread_cond_destroy(&pool->finished);
+  pthread_cond_destroy(&pool->started);
+  pthread_mutex_destroy(&pool->mutex);
+}
+
+#endif
+
+/**
+ * Runs jobs of the current batch until there are none left.
+ *
+ * Must be called with the mutex locked, and returns with it locked.
+ */
+static void run_jobs(WorkerPool *pool) {
+  size_t job;
+  while (pool->next_job < pool->job_count) {
+    job = pool->next_job++;
+    unlock(&pool->mutex);
+    pool->job(pool->context, job);
+    lock(&pool->mutex);
+  }
+}
+
+static void work(WorkerPool *pool) {
+  unsigned long batch = 0;
+  lock(&pool->mutex);
+  for (;;) {
+    while (pool->batch == batch && !pool->stopping) {
+      wait_for(&pool->started, &pool->mutex);
+    }
+    if (pool->stopping) {
+      break;
+    }
+    batch = pool->batch;
+    run_jobs(pool);
+    pool->busy_workers--;
+    if (pool->busy_workers == 0) {
+      signal_all(&pool->finished);
+    }
+  }
+  unlock(&pool->mutex);
+}
+
+#ifdef _WIN32
+
+static DWORD WINAPI start_worker(LPVOID pool) {
+  work(pool);
+  return 0;
+}
+
+static int start_thread(Thread *thread, WorkerPool *pool) {
+  *thread = CreateThread(NULL, 0, start_worker, pool, 0, NULL);
+  return *thread != NULL;
+}
+
+static void join_thread(Thread thread) {
+  WaitForSingleObject(thread, INFINITE);
+  CloseHandle(thread);
+}
+
+#else
+
+static void *start_worker(void *pool) {
+  work(pool);
+  return NULL;
+}
+
+static int start_thread(Thread *thread, WorkerPool *pool) {
+  return pthread_create(thread, NULL, start_worker, pool) == 0;
+}
+
+static void join_thread(Thread thread) { pthread_join(thread, NULL); }
+
+#endif
+
+/**
+ * Stops and joins the first count workers of the pool.
+ */
+static void stop_workers(WorkerPool *pool, const size_t count) {
+  size_t i;
+  lock(&pool->mutex);
+  pool->stopping = 1;
+  signal_all(&pool->started);
+  unlock(&pool->mutex);
+  for (i = 0; i < count; i++) {
+    join_thread(pool->workers[i]);
+  }
+}
+
+WorkerPool *create_worker_pool(const size_t thread_count) {
+  WorkerPool *pool = resize_memory(NULL, sizeof(WorkerPool));
+  size_t i;
+  pool->worker_count = thread_count > 1 ? thread_count - 1 : 0;
+  pool->workers = resize_memory(NULL, sizeof(Thread) * (pool->worker_count ? pool->worker_count : 1));
+  pool->batch = 0;
+  pool->stopping = 0;
+  pool->job = NULL;
+  pool->context = NULL;
+  pool->job_count = 0;
+  pool->next_job = 0;
+  pool->busy_workers = 0;
+  initialize_synchronization(pool);
+  for (i = 0; i < pool->worker_count; i++) {
+    if (!start_thread(pool->workers + i, pool)) {
+      log_message("Failed to start a worker thread.");
+      stop_workers(pool, i);
+      finalize_synchronization(pool);
+      pool->workers = resize_memory(pool->workers, 0);
+      return resize_memory(pool, 0);
+    }
+  }
+  return pool;
+}
+
+WorkerPool *destroy_worker_pool(WorkerPool *pool) {
+  if (pool != NULL) {
+    stop_workers(pool, pool->worker_count);
+    finalize_synchronization(pool);
+    pool->workers = resize_memory(pool->workers, 0);
+  }
+  return resize_memory(pool, 0);
+}
+
+/**
+ * Runs jobs 0 to job_count - 1 on the threads of the pool, returning after all of them finished.
+ */
+void worker_pool_run(WorkerPool *pool, WorkerJob job, void *context, const size_t job_count) {
+  lock(&pool->mutex);
+  pool->job = job;
+  pool->context = context;
+  pool->job_count = job_count;
+  pool->next_job = 0;
+  pool->busy_workers = pool->worker_count;
+  pool->batch++;
+  signal_all(&pool->started);
+  run_jobs(pool);
+  while (pool->busy_workers > 0) {
+    wait_for(&pool->finished, &pool->mutex);
+  }
+  unlock(&pool->mutex);
+}
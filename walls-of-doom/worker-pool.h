@@ -0,0 +1,34 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <stdlib.h>
+
+/**
+ * A pool of worker threads which run batches of numbered jobs.
+ *
+ * The thread which runs a batch works on it as well, so a pool of n threads has n - 1 workers. Jobs of a batch may run
+ * in any order and on any thread, so they should not depend on each other.
+ */
+
+typedef struct WorkerPool WorkerPool;
+
+/**
+ * Runs the job with the provided number.
+ */
+typedef void (*WorkerJob)(void *context, size_t job);
+
+/**
+ * Creates a new WorkerPool which runs batches on the provided number of threads.
+ *
+ * Returns NULL if the threads could not be started.
+ */
+WorkerPool *create_worker_pool(const size_t thread_count);
+
+WorkerPool *destroy_worker_pool(WorkerPool *pool);
+
+/**
+ * Runs jobs 0 to job_count - 1 on the threads of the pool, returning after all of them finished.
+ */
+void worker_pool_run(WorkerPool *pool, WorkerJob job, void *context, const size_t job_count);
+
+#endif